@@ -0,0 +1,64 @@
+#include "BitLUT.h"
+
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+
+namespace db {
+
+BitLUT::BitLUT(const vector<vector<bool>>& lut)
+    : numRows(lut.size()), numCols(lut.empty() ? 0 : lut[0].size()), rowStride((numCols + 63) / 64) {
+    words.assign(numRows * rowStride, 0);
+    for (int x = 0; x < numRows; ++x) {
+        for (int y = 0; y < numCols; ++y) {
+            if (lut[x][y]) words[x * rowStride + (y >> 6)] |= 1ULL << (y & 63);
+        }
+    }
+}
+
+int BitLUT::firstInRow(int x, int yLow, int yHigh) const {
+    if (yLow > yHigh) return -1;
+    for (int w = yLow >> 6; w <= (yHigh >> 6); ++w) {
+        uint64_t word = maskedWord(x, w, yLow, yHigh);
+        if (word) return w * 64 + __builtin_ctzll(word);
+    }
+    return -1;
+}
+
+int BitLUT::lastInRow(int x, int yLow, int yHigh) const {
+    if (yLow > yHigh) return -1;
+    for (int w = yHigh >> 6; w >= (yLow >> 6); --w) {
+        uint64_t word = maskedWord(x, w, yLow, yHigh);
+        if (word) return w * 64 + 63 - __builtin_clzll(word);
+    }
+    return -1;
+}
+
+bool BitLUT::operator==(const BitLUT& rhs) const {
+    return numRows == rhs.numRows && numCols == rhs.numCols && words == rhs.words;
+}
+
+size_t BitLUT::hash() const {
+    size_t seed = 0;
+    boost::hash_combine(seed, numRows);
+    boost::hash_combine(seed, numCols);
+    boost::hash_range(seed, words.begin(), words.end());
+    return seed;
+}
+
+BitLUTs::BitLUTs(const vector<vector<vector<bool>>>& cpLUTs) {
+    auto hasher = [](const BitLUT& lut) { return lut.hash(); };
+    std::unordered_map<BitLUT, int, decltype(hasher)> lutToIdx(cpLUTs.size(), hasher);
+    lutIdxs.reserve(cpLUTs.size());
+    for (const auto& cpLUT : cpLUTs) {
+        BitLUT lut(cpLUT);
+        auto it = lutToIdx.find(lut);
+        if (it == lutToIdx.end()) {
+            it = lutToIdx.emplace(lut, luts.size()).first;
+            luts.push_back(std::move(lut));
+        }
+        lutIdxs.push_back(it->second);
+    }
+}
+
+}  // namespace db
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "global.h"
+
+namespace db {
+
+// A conflict LUT (x, y) packed into 64-bit words, each row starts at a word boundary (fixed row stride)
+class BitLUT {
+public:
+    BitLUT() = default;
+    BitLUT(const vector<vector<bool>>& lut);
+
+    int xSize() const { return numRows; }
+    int ySize() const { return numCols; }
+    bool empty() const { return numRows == 0; }
+    bool operator()(int x, int y) const { return (words[x * rowStride + (y >> 6)] >> (y & 63)) & 1; }
+    const uint64_t* row(int x) const { return words.data() + x * rowStride; }
+    int rowWords() const { return rowStride; }
+
+    // the first/last set y in [yLow, yHigh] of row x, -1 if there is none
+    int firstInRow(int x, int yLow, int yHigh) const;
+    int lastInRow(int x, int yLow, int yHigh) const;
+    // visit the set y in [yLow, yHigh] of row x in increasing order
+    template <typename HandleT>
+    void forEachInRow(int x, int yLow, int yHigh, const HandleT& handle) const {
+        if (yLow > yHigh) return;
+        for (int w = yLow >> 6; w <= (yHigh >> 6); ++w) {
+            for (uint64_t word = maskedWord(x, w, yLow, yHigh); word; word &= word - 1) {
+                handle(w * 64 + __builtin_ctzll(word));
+            }
+        }
+    }
+
+    bool operator==(const BitLUT& rhs) const;
+    size_t hash() const;
+
+private:
+    int numRows = 0;
+    int numCols = 0;
+    int rowStride = 0;  // # words per row
+    vector<uint64_t> words;
+
+    // word w of row x with the bits out of [yLow, yHigh] cleared
+    uint64_t maskedWord(int x, int w, int yLow, int yHigh) const {
+        uint64_t word = words[x * rowStride + w];
+        int low = yLow - w * 64, high = yHigh - w * 64;
+        if (low > 0) word &= ~0ULL << low;
+        if (high < 63) word &= ~0ULL >> (63 - high);
+        return word;
+    }
+};
+
+// LUTs of all cross points, where cross points with identical LUTs share the same storage
+class BitLUTs {
+public:
+    BitLUTs() = default;
+    BitLUTs(const vector<vector<vector<bool>>>& cpLUTs);
+
+    const BitLUT& operator[](int crossPointIdx) const { return luts[lutIdxs[crossPointIdx]]; }
+    int size() const { return lutIdxs.size(); }
+    bool empty() const { return lutIdxs.empty(); }
+    const vector<BitLUT>& uniqueLUTs() const { return luts; }
+
+private:
+    vector<BitLUT> luts;
+    vector<int> lutIdxs;  // crossPointIdx -> idx in luts
+};
+
+}  // namespace db
@@ -160,17 +160,17 @@ ostream& CutLayer::printViaOccupancyLUT(ostream& os) const {
     os << name << ": viaCut(" << viaCut().size() / 2 + 1 << ',' << viaCut()[0].size() / 2 + 1 << ")";
     os << ", viaMetal(" << viaMetal().size() / 2 + 1 << ',' << viaMetal()[0].size() / 2 + 1 << ")";
     // TODO: make xSize member variables, since they will be the same in a LUT over all cps
-    auto getMaxSize = [](const vector<vector<vector<bool>>>& LUT, size_t& xSize, size_t& ySize) {
+    auto getMaxSize = [](const BitLUTs& LUT, int& xSize, int& ySize) {
         xSize = 0;
         ySize = 0;
-        for (const vector<vector<bool>>& cpLUT : LUT) {
-            if (cpLUT.size()) {
-                xSize = max(xSize, cpLUT.size());
-                ySize = max(ySize, cpLUT[0].size());
+        for (const BitLUT& cpLUT : LUT.uniqueLUTs()) {
+            if (!cpLUT.empty()) {
+                xSize = max(xSize, cpLUT.xSize());
+                ySize = max(ySize, cpLUT.ySize());
             }
         }
     };
-    size_t xSize, ySize;
+    int xSize, ySize;
     os << ", viaBotVia(";
     if (defaultViaType().allViaBotVia.size()) {
         getMaxSize(viaBotVia(), xSize, ySize);
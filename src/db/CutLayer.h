@@ -1,5 +1,6 @@
 #pragma once
 
+#include "BitLUT.h"
 #include "GeoPrimitive.h"
 
 namespace db {
@@ -17,8 +18,8 @@ public:
     vector<utils::BoxT<DBU>> topForbidRegions;
 
     // via-wire conflict (crossPointIdx, trackIdx, crossPointIdx)
-    vector<vector<vector<bool>>> viaBotWire;
-    vector<vector<vector<bool>>> viaTopWire;
+    BitLUTs viaBotWire;
+    BitLUTs viaTopWire;
 
     // same-layer via-via conflict (viaTypeIdx, lowerTrackIdx, upperTrackIdx)
     // TODO: remove allViaMetal, rename allViaMetalNum to allViaMetal
@@ -27,13 +28,13 @@ public:
     vector<vector<vector<int>>> allViaMetalNum;  // due to metal spacing, integer version
 
     // cross-layer via-via conflict (viaTypeIdx, crossPointIdx, trackIdx, crossPointIdx)
-    vector<vector<vector<vector<bool>>>> allViaBotVia;
-    vector<vector<vector<vector<bool>>>> allViaTopVia;
+    vector<BitLUTs> allViaBotVia;
+    vector<BitLUTs> allViaTopVia;
 
     // merged LUTs
     vector<vector<bool>> mergedAllViaMetal;
-    vector<vector<vector<bool>>> mergedAllViaBotVia;
-    vector<vector<vector<bool>>> mergedAllViaTopVia;
+    BitLUTs mergedAllViaBotVia;
+    BitLUTs mergedAllViaTopVia;
 
     ViaType() {}
     ViaType(Rsyn::PhysicalVia rsynVia);
@@ -77,11 +78,11 @@ public:
     const vector<vector<bool>>& viaMetal() const { return defaultViaType().allViaMetal[0]; }
     const vector<vector<int>>& viaMetalNum() const { return defaultViaType().allViaMetalNum[0]; }
     // 2. via-via conflict (crossPointIdx, trackIdx, crossPointIdx)
-    const vector<vector<vector<bool>>>& viaBotVia() const { return defaultViaType().allViaBotVia[0]; }
-    const vector<vector<vector<bool>>>& viaTopVia() const { return defaultViaType().allViaTopVia[0]; }
+    const BitLUTs& viaBotVia() const { return defaultViaType().allViaBotVia[0]; }
+    const BitLUTs& viaTopVia() const { return defaultViaType().allViaTopVia[0]; }
     // 3. via-wire conflict (crossPointIdx, trackIdx, crossPointIdx)
-    const vector<vector<vector<bool>>>& viaBotWire() const { return defaultViaType().viaBotWire; }
-    const vector<vector<vector<bool>>>& viaTopWire() const { return defaultViaType().viaTopWire; }
+    const BitLUTs& viaBotWire() const { return defaultViaType().viaBotWire; }
+    const BitLUTs& viaTopWire() const { return defaultViaType().viaTopWire; }
 
     ostream& printBasics(ostream& os) const;
     ostream& printDesignRules(ostream& os) const;
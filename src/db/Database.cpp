@@ -3,6 +3,7 @@
 #include "single_net/PinTapConnector.h"
 
 db::Database database;
+utils::thread_pool threadPool;
 
 namespace db {
 
@@ -37,6 +38,9 @@ void Database::init() {
     log() << "Finish initializing database" << std::endl;
     log() << "MEM: cur=" << utils::mem_use::get_current() << "MB, peak=" << utils::mem_use::get_peak() << "MB"
           << std::endl;
+    if (setting.numaAware) {
+        log() << "MEM per NUMA node (MB): " << utils::numa::mem_use_per_node() << std::endl;
+    }
     log() << std::endl;
 }
 
@@ -732,7 +736,7 @@ void Database::getGridPinAccessBoxes(const Net& net, vector<vector<db::GridBoxOn
 
 }  // namespace db
 
-MTStat runJobsMT(int numJobs, const std::function<void(int)>& handle) {
+MTStat runJobsMT(int numJobs, const std::function<void(int)>& handle, int chunkSize, bool inOrder) {
     int numThreads = min(numJobs, db::setting.numThreads);
     MTStat mtStat(max(1, db::setting.numThreads));
     if (numThreads <= 1) {
@@ -742,29 +746,14 @@ MTStat runJobsMT(int numJobs, const std::function<void(int)>& handle) {
         }
         mtStat.durations[0] = threadTimer.elapsed();
     } else {
-        int globalJobIdx = 0;
-        std::mutex mtx;
-        utils::timer threadTimer;
-        auto thread_func = [&](int threadIdx) {
-            int jobIdx;
-            while (true) {
-                mtx.lock();
-                jobIdx = globalJobIdx++;
-                mtx.unlock();
-                if (jobIdx >= numJobs) {
-                    mtStat.durations[threadIdx] = threadTimer.elapsed();
-                    break;
-                }
-                handle(jobIdx);
-            }
-        };
-
-        std::thread threads[numThreads];
-        for (int i = 0; i < numThreads; i++) {
-            threads[i] = std::thread(thread_func, i);
+        if (chunkSize <= 0) {
+            // a few chunks per thread are enough for stealing to balance the load
+            chunkSize = max(1, numJobs / (db::setting.numThreads * 32));
         }
-        for (int i = 0; i < numThreads; i++) {
-            threads[i].join();
+        threadPool.run(numJobs, chunkSize, handle, inOrder);
+        const auto& durations = threadPool.durations();
+        for (int i = 0; i < min<int>(durations.size(), mtStat.durations.size()); ++i) {
+            mtStat.durations[i] = durations[i];
         }
     }
     return mtStat;
@@ -74,4 +74,6 @@ struct hash<std::tuple<t0, t1, t2>> {
 
 }  // namespace std
 
-MTStat runJobsMT(int numJobs, const std::function<void(int)>& handle);
+// run handle(0), ..., handle(numJobs - 1) on threadPool, chunkSize <= 0 for an automatic chunk size
+// inOrder: start jobs in index order (e.g., jobs sorted by decreasing runtime for LPT)
+MTStat runJobsMT(int numJobs, const std::function<void(int)>& handle, int chunkSize = 0, bool inOrder = false);
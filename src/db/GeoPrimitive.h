@@ -56,7 +56,11 @@ namespace std {
 template <>
 struct hash<db::GridPoint> {
     std::size_t operator()(const db::GridPoint& gp) const {
-        return (std::hash<int>()(gp.layerIdx) ^ std::hash<int>()(gp.trackIdx) ^ std::hash<int>()(gp.crossPointIdx));
+        std::size_t seed = 0;
+        boost::hash_combine(seed, gp.layerIdx);
+        boost::hash_combine(seed, gp.trackIdx);
+        boost::hash_combine(seed, gp.crossPointIdx);
+        return seed;
     }
 };
 
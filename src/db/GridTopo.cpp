@@ -19,22 +19,6 @@ void GridSteiner::resetParent(std::shared_ptr<GridSteiner> node) {
     node->parent.reset();
 }
 
-void GridSteiner::preOrder(std::shared_ptr<GridSteiner> node, const std::function<void(std::shared_ptr<GridSteiner>)>& visit) {
-    visit(node);
-    for (auto c : node->children) preOrder(c, visit);
-}
-
-void GridSteiner::postOrder(std::shared_ptr<GridSteiner> node, const std::function<void(std::shared_ptr<GridSteiner>)>& visit) {
-    for (auto c : node->children) postOrder(c, visit);
-    visit(node);
-}
-
-void GridSteiner::postOrderCopy(std::shared_ptr<GridSteiner> node, const std::function<void(std::shared_ptr<GridSteiner>)>& visit) {
-    auto tmp = node->children;
-    for (auto c : tmp) postOrderCopy(c, visit);
-    visit(node);
-}
-
 void GridSteiner::mergeNodes(std::shared_ptr<GridSteiner> root) {
     postOrderCopy(root, [](std::shared_ptr<GridSteiner> node) {
         // parent - node - child
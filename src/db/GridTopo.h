@@ -23,13 +23,23 @@ public:
     static void setParent(std::shared_ptr<GridSteiner> childNode, std::shared_ptr<GridSteiner> parentNode);
     static void resetParent(std::shared_ptr<GridSteiner> node);
 
-    // Traverse
-    static void preOrder(std::shared_ptr<GridSteiner> node,
-                         const std::function<void(std::shared_ptr<GridSteiner>)>& visit);
-    static void postOrder(std::shared_ptr<GridSteiner> node,
-                          const std::function<void(std::shared_ptr<GridSteiner>)>& visit);
-    static void postOrderCopy(std::shared_ptr<GridSteiner> node,
-                              const std::function<void(std::shared_ptr<GridSteiner>)>& visit);
+    // Traverse (visit: any callable on std::shared_ptr<GridSteiner>)
+    template <typename VisitT>
+    static void preOrder(std::shared_ptr<GridSteiner> node, const VisitT& visit) {
+        visit(node);
+        for (auto c : node->children) preOrder(c, visit);
+    }
+    template <typename VisitT>
+    static void postOrder(std::shared_ptr<GridSteiner> node, const VisitT& visit) {
+        for (auto c : node->children) postOrder(c, visit);
+        visit(node);
+    }
+    template <typename VisitT>
+    static void postOrderCopy(std::shared_ptr<GridSteiner> node, const VisitT& visit) {
+        auto tmp = node->children;
+        for (auto c : tmp) postOrderCopy(c, visit);
+        visit(node);
+    }
 
     // Merge two same-layer edges (assume they are on the same track)
     static void mergeNodes(std::shared_ptr<GridSteiner> root);
@@ -0,0 +1,38 @@
+#include "HistViaMap.h"
+
+namespace db {
+
+namespace {
+bool lessCP(const HistViaMap::value_type& lhs, int crossPointIdx) { return lhs.first < crossPointIdx; }
+}  // namespace
+
+HistUsageT HistViaMap::get(int crossPointIdx) const {
+    auto it = std::lower_bound(usages.begin(), usages.end(), crossPointIdx, lessCP);
+    return (it != usages.end() && it->first == crossPointIdx) ? it->second : 0.0;
+}
+
+void HistViaMap::add(int crossPointIdx, HistUsageT usage) {
+    // the cross points usually come in increasing order (e.g., addViaHistCost), so try appending first
+    if (usages.empty() || usages.back().first < crossPointIdx) {
+        usages.emplace_back(crossPointIdx, usage);
+        return;
+    }
+    auto it = std::lower_bound(usages.begin(), usages.end(), crossPointIdx, lessCP);
+    if (it != usages.end() && it->first == crossPointIdx) {
+        it->second += usage;
+    } else {
+        usages.insert(it, {crossPointIdx, usage});
+    }
+}
+
+void HistViaMap::scale(HistUsageT factor, HistUsageT eps) {
+    auto out = usages.begin();
+    for (const auto& usage : usages) {
+        HistUsageT scaled = usage.second * factor;
+        if (scaled >= eps) *out++ = {usage.first, scaled};
+    }
+    usages.erase(out, usages.end());
+    if (usages.capacity() > 2 * usages.size()) usages.shrink_to_fit();
+}
+
+}  // namespace db
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "global.h"
+
+namespace db {
+
+using HistUsageT = double;
+
+// Hist usages of vias on one track: (crossPointIdx, usage) sorted by crossPointIdx
+// The usages are kept unscaled, i.e., the real usage is usage x a scale shared by all the tracks (see RouteGrid), so
+// that fading all the hist vias only updates the scale.
+class HistViaMap {
+public:
+    using value_type = std::pair<int, HistUsageT>;
+    using const_iterator = vector<value_type>::const_iterator;
+
+    HistUsageT get(int crossPointIdx) const;  // 0 if not found
+    void add(int crossPointIdx, HistUsageT usage);
+    // multiply all the usages by factor, and drop the ones below eps
+    void scale(HistUsageT factor, HistUsageT eps);
+
+    const_iterator begin() const { return usages.begin(); }
+    const_iterator end() const { return usages.end(); }
+    bool empty() const { return usages.empty(); }
+    int size() const { return usages.size(); }
+
+private:
+    vector<value_type> usages;
+};
+
+}  // namespace db
@@ -480,6 +480,13 @@ void LayerList::initViaWire(const int layerIdx,
 }
 
 void LayerList::initViaConfLUT() {
+    // the cross-point LUTs are built in vector<bool> first, and packed into BitLUTs after merging
+    using CpLUTs = vector<vector<vector<bool>>>;                    // (crossPointIdx, trackIdx, crossPointIdx)
+    vector<vector<vector<CpLUTs>>> allViaBotVia(cutLayers.size());  // (cutLayerIdx, viaTypeIdx, viaTypeIdx)
+    vector<vector<vector<CpLUTs>>> allViaTopVia(cutLayers.size());
+    vector<vector<CpLUTs>> wireBotVia(layers.size());  // (layerIdx, viaTypeIdx)
+    vector<vector<CpLUTs>> wireTopVia(layers.size());
+
     for (unsigned i = 0; i != cutLayers.size(); ++i) {
         CutLayer& cutLayer = cutLayers[i];
         // Loops for init all-all via-via LUTs
@@ -500,27 +507,31 @@ void LayerList::initViaConfLUT() {
         //  2. init viaTopVia & viaBotVia
         if (i > 0) {
             // Loops for init all-all via-via LUTs
+            allViaBotVia[i].resize(cutLayer.allViaTypes.size(), vector<CpLUTs>(cutLayers[i - 1].allViaTypes.size()));
+            allViaTopVia[i - 1].resize(cutLayers[i - 1].allViaTypes.size(),
+                                       vector<CpLUTs>(cutLayer.allViaTypes.size()));
             for (unsigned j = 0; j != cutLayer.allViaTypes.size(); ++j) {
                 ViaType& viaType1 = cutLayer.allViaTypes[j];
-                viaType1.allViaBotVia.resize(cutLayers[i - 1].allViaTypes.size());
                 for (unsigned k = 0; k != cutLayers[i - 1].allViaTypes.size(); ++k) {
                     ViaType& viaType2 = cutLayers[i - 1].allViaTypes[k];
-                    viaType2.allViaTopVia.resize(cutLayer.allViaTypes.size());
-                    auto& viaBotVia = viaType1.allViaBotVia[k];
-                    auto& viaTopVia = viaType2.allViaTopVia[j];
+                    auto& viaBotVia = allViaBotVia[i][j][k];
+                    auto& viaTopVia = allViaTopVia[i - 1][k][j];
                     initDiffLayerViaConfLUT(i, viaType1, viaType2, viaBotVia, viaTopVia);
                 }
             }
         }
 
         //  3. init viaBotWire & viaTopWire
-        layers[i].wireTopVia.resize(cutLayer.allViaTypes.size());
-        layers[i + 1].wireBotVia.resize(cutLayer.allViaTypes.size());
+        wireTopVia[i].resize(cutLayer.allViaTypes.size());
+        wireBotVia[i + 1].resize(cutLayer.allViaTypes.size());
         for (auto& viaType : cutLayer.allViaTypes) {
-            initViaWire(i, viaType.bot, viaType.viaBotWire);
-            initViaWire(i + 1, viaType.top, viaType.viaTopWire);
-            LayerList::initOppLUT(viaType.viaBotWire, layers[i].wireTopVia[viaType.idx]);
-            LayerList::initOppLUT(viaType.viaTopWire, layers[i + 1].wireBotVia[viaType.idx]);
+            CpLUTs viaBotWire, viaTopWire;
+            initViaWire(i, viaType.bot, viaBotWire);
+            initViaWire(i + 1, viaType.top, viaTopWire);
+            LayerList::initOppLUT(viaBotWire, wireTopVia[i][viaType.idx]);
+            LayerList::initOppLUT(viaTopWire, wireBotVia[i + 1][viaType.idx]);
+            viaType.viaBotWire = BitLUTs(viaBotWire);
+            viaType.viaTopWire = BitLUTs(viaTopWire);
         }
     }
 
@@ -529,38 +540,38 @@ void LayerList::initViaConfLUT() {
         layer.initWireRange();
     }
 
-    // Merge LUTs
+    // Merge & pack LUTs
     for (unsigned i = 0; i != cutLayers.size(); ++i) {
         CutLayer& cutLayer = cutLayers[i];
         for (unsigned j = 0; j != cutLayer.allViaTypes.size(); ++j) {
             ViaType& viaType = cutLayer.allViaTypes[j];
             viaType.mergedAllViaMetal = mergeLUTs(viaType.allViaMetal);
-            if (i > 0) {
-                for (int k = 0; k != viaType.allViaBotVia.size(); ++k) {
-                    viaType.mergedAllViaBotVia = mergeLUTsCP(viaType.allViaBotVia);
-                }
+            if (!allViaBotVia[i].empty()) {
+                viaType.allViaBotVia.assign(allViaBotVia[i][j].begin(), allViaBotVia[i][j].end());
+                viaType.mergedAllViaBotVia = mergeLUTsCP(allViaBotVia[i][j]);
             }
-            if (i < cutLayers.size()) {
-                for (int k = 0; k != viaType.allViaTopVia.size(); ++k) {
-                    viaType.mergedAllViaTopVia = mergeLUTsCP(viaType.allViaTopVia);
-                }
+            if (!allViaTopVia[i].empty()) {
+                viaType.allViaTopVia.assign(allViaTopVia[i][j].begin(), allViaTopVia[i][j].end());
+                viaType.mergedAllViaTopVia = mergeLUTsCP(allViaTopVia[i][j]);
             }
         }
     }
     for (int i = 0; i < layers.size(); ++i) {
         MetalLayer& layer = layers[i];
+        layer.wireBotVia.assign(wireBotVia[i].begin(), wireBotVia[i].end());
+        layer.wireTopVia.assign(wireTopVia[i].begin(), wireTopVia[i].end());
         if (i > 0) {
-            layer.mergedWireBotVia = mergeLUTsCP(layer.wireBotVia);
+            layer.mergedWireBotVia = mergeLUTsCP(wireBotVia[i]);
         }
         if ((i + 1) < layers.size()) {
-            layer.mergedWireTopVia = mergeLUTsCP(layer.wireTopVia);
+            layer.mergedWireTopVia = mergeLUTsCP(wireTopVia[i]);
         }
     }
 
     // Set isWireViaMultiTrack
     for (int i = 0; i < layers.size(); ++i) {
-        if (i > 0 && layers[i].wireBotVia[0][0].size() > 1 ||
-            (i + 1) < layers.size() && layers[i].wireTopVia[0][0].size() > 1)
+        if (i > 0 && layers[i].wireBotVia[0][0].xSize() > 1 ||
+            (i + 1) < layers.size() && layers[i].wireTopVia[0][0].xSize() > 1)
             layers[i].isWireViaMultiTrack = true;
     }
 
@@ -867,11 +878,13 @@ void LayerList::writeDefConflictLUTs(const std::string& debugFileName) const {
         ofs << "viaBotVia" << std::endl;
         cpIdx = 0;
         if (cutLayer.idx > 0) {
-            for (const auto& cp : cutLayer.allViaTypes[0].allViaBotVia[0]) {
-                ofs << "cpidx is: " << cpIdx++ << std::endl;
-                for (auto a : cp) {
-                    for (auto b : a) {
-                        ofs << (int)(b) << " ";
+            const BitLUTs& viaBotVia = cutLayer.allViaTypes[0].allViaBotVia[0];
+            for (; cpIdx != viaBotVia.size(); ++cpIdx) {
+                ofs << "cpidx is: " << cpIdx << std::endl;
+                const BitLUT& cp = viaBotVia[cpIdx];
+                for (int a = 0; a != cp.xSize(); ++a) {
+                    for (int b = 0; b != cp.ySize(); ++b) {
+                        ofs << (int)(cp(a, b)) << " ";
                     }
                     ofs << std::endl;
                 }
@@ -880,11 +893,13 @@ void LayerList::writeDefConflictLUTs(const std::string& debugFileName) const {
         ofs << "viaTopVia" << std::endl;
         cpIdx = 0;
         if (cutLayer.idx < cutLayers.size() - 1) {
-            for (const auto& cp : cutLayer.allViaTypes[0].allViaTopVia[0]) {
-                ofs << "cpidx is: " << cpIdx++ << std::endl;
-                for (auto a : cp) {
-                    for (auto b : a) {
-                        ofs << (int)(b) << " ";
+            const BitLUTs& viaTopVia = cutLayer.allViaTypes[0].allViaTopVia[0];
+            for (; cpIdx != viaTopVia.size(); ++cpIdx) {
+                ofs << "cpidx is: " << cpIdx << std::endl;
+                const BitLUT& cp = viaTopVia[cpIdx];
+                for (int a = 0; a != cp.xSize(); ++a) {
+                    for (int b = 0; b != cp.ySize(); ++b) {
+                        ofs << (int)(cp(a, b)) << " ";
                     }
                     ofs << std::endl;
                 }
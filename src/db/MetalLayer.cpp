@@ -452,13 +452,13 @@ ostream& MetalLayer::printDesignRules(ostream& os) const {
 }
 
 ostream& MetalLayer::printViaOccupancyLUT(ostream& os) const {
-    auto getMaxSize2d = [](const vector<vector<vector<bool>>>& LUT, size_t& xSize, size_t& ySize) {
+    auto getMaxSize2d = [](const BitLUTs& LUT, int& xSize, int& ySize) {
         xSize = 0;
         ySize = 0;
-        for (const vector<vector<bool>>& cpLUT : LUT) {
-            if (cpLUT.size()) {
-                xSize = max(xSize, cpLUT.size());
-                ySize = max(ySize, cpLUT[0].size());
+        for (const BitLUT& cpLUT : LUT.uniqueLUTs()) {
+            if (!cpLUT.empty()) {
+                xSize = max(xSize, cpLUT.xSize());
+                ySize = max(ySize, cpLUT.ySize());
             }
         }
     };
@@ -468,7 +468,7 @@ ostream& MetalLayer::printViaOccupancyLUT(ostream& os) const {
             yRange = yRange.UnionWith(rangeCP);
         }
     };
-    size_t xSize, ySize;
+    int xSize, ySize;
     utils::IntervalT<int> yRange;
     getMaxSize1d(wireRange, yRange);
     os << name << ": wire(" << wireRange.size() << ',' << yRange << ')';
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "BitLUT.h"
 #include "GeoPrimitive.h"
 
 namespace db {
@@ -157,10 +158,10 @@ public:
 
     // Via conflict lookup table (true means "available" / no conflict)
     // 1. wire-via conflict (viaTypeIdx, crossPointIdx, trackIdx, crossPointIdx)
-    vector<vector<vector<vector<bool>>>> wireBotVia;
-    vector<vector<vector<vector<bool>>>> wireTopVia;
-    vector<vector<vector<bool>>> mergedWireBotVia;
-    vector<vector<vector<bool>>> mergedWireTopVia;
+    vector<BitLUTs> wireBotVia;
+    vector<BitLUTs> wireTopVia;
+    BitLUTs mergedWireBotVia;
+    BitLUTs mergedWireTopVia;
     bool isWireViaMultiTrack = false;
     // 2. wire-wire conflict (crossPointIdx, crossPointIdx)
     vector<utils::IntervalT<int>> wireRange;
@@ -24,12 +24,6 @@ BoxOnLayer NetBase::getMaxAccessBox(int pinIdx) const {
     return bestBox;
 }
 
-void NetBase::postOrderVisitGridTopo(const std::function<void(std::shared_ptr<GridSteiner>)>& visit) const {
-    for (const std::shared_ptr<GridSteiner>& tree : gridTopo) {
-        GridSteiner::postOrder(tree, visit);
-    }
-}
-
 void NetBase::printBasics(ostream& os) const {
     os << "Net " << getName() << " (idx = " << idx << ") with " << numOfPins() << " pins " << std::endl;
     for (int i = 0; i < numOfPins(); ++i) {
@@ -26,7 +26,12 @@ public:
     // on-grid route result
     vector<std::shared_ptr<GridSteiner>> gridTopo;
     vector<std::shared_ptr<GridSteiner>> gridTopo_copy;
-    void postOrderVisitGridTopo(const std::function<void(std::shared_ptr<GridSteiner>)>& visit) const;
+    template <typename VisitT>
+    void postOrderVisitGridTopo(const VisitT& visit) const {
+        for (const std::shared_ptr<GridSteiner>& tree : gridTopo) {
+            GridSteiner::postOrder(tree, visit);
+        }
+    }
 
     // print
     void printBasics(ostream& os) const;
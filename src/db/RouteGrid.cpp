@@ -3,6 +3,20 @@
 
 namespace db {
 
+namespace {
+// Per-thread buffers of the cost queries, which keep their capacity over calls (i.e., allocate only when growing)
+struct CostQueryBuffers {
+    vector<int> routedWire;
+    vector<int> poorWire;
+    vector<HistUsageT> histWire;
+    vector<int> crossPoints;
+};
+CostQueryBuffers& costQueryBuffers() {
+    thread_local CostQueryBuffers buffers;
+    return buffers;
+}
+}  // namespace
+
 void RouteGrid::init() {
     if (db::setting.dbVerbose >= +db::VerboseLevelT::MIDDLE) {
         log() << "Init RouteGrid ..." << std::endl;
@@ -14,25 +28,50 @@ void RouteGrid::init() {
     routedWireMap.resize(layers.size());
     poorWireMap.resize(layers.size());
     histWireMap.resize(layers.size());
-    wireLocks.resize(layers.size());
     // Via
     routedViaMap.resize(layers.size());       // the last layer will not be used
     routedViaMapUpper.resize(layers.size());  // the first layer will not be used
-    viaLocks.resize(layers.size());           // the last layer will not be used
-    viaLocksUpper.resize(layers.size());      // the first layer will not be used
     histViaMap.resize(layers.size());         // the last layer will not be used
-    for (int i = 0; i < layers.size(); ++i) {
+    // Locks (elided when single-threaded)
+    lockOnWrite = (setting.numThreads > 1);
+    auto initLayer = [&](int i) {
         // Wire
         routedWireMap[i].resize(layers[i].numTracks());
         poorWireMap[i].resize(layers[i].numTracks());
         histWireMap[i].resize(layers[i].numTracks());
-        wireLocks[i].resize(layers[i].numTracks());
         // Via
         routedViaMap[i].resize(layers[i].numTracks());
         routedViaMapUpper[i].resize(layers[i].numTracks());
-        viaLocks[i].resize(layers[i].numTracks());
-        viaLocksUpper[i].resize(layers[i].numTracks());
         histViaMap[i].resize(layers[i].numTracks());
+        // Cost caches
+        if (setting.dbUseTrackCostCache) {
+            trackCostCaches[i].resize(layers[i].numTracks());
+            trackVersions[i].resize(layers[i].numTracks(), 0);
+        }
+    };
+    if (setting.dbUseTrackCostCache) {
+        trackCostCaches.resize(layers.size());
+        trackVersions.resize(layers.size());
+    }
+    if (setting.numaAware) {
+        // first touch by pinned threads, so that the layers are spread over NUMA nodes, i.e., layer i by the first
+        // worker of the (i % # nodes with workers)-th node
+        // Note: only the per-track headers are placed here, the segments of the maps are allocated later by the
+        // thread committing them
+        vector<int> firstWorkers;
+        for (int threadIdx = 0; threadIdx < threadPool.size(); ++threadIdx) {
+            if (threadIdx == 0 || utils::numa::node_of_thread(threadIdx, threadPool.size()) !=
+                                      utils::numa::node_of_thread(threadIdx - 1, threadPool.size())) {
+                firstWorkers.push_back(threadIdx);
+            }
+        }
+        threadPool.run_on_all([&](int threadIdx) {
+            for (int i = 0; i < layers.size(); ++i) {
+                if (firstWorkers[i % firstWorkers.size()] == threadIdx) initLayer(i);
+            }
+        });
+    } else {
+        for (int i = 0; i < layers.size(); ++i) initLayer(i);
     }
 
     DBU m2Pitch = layers[1].pitch;
@@ -84,13 +123,15 @@ void RouteGrid::clear() {
     routedWireMap.clear();
     poorWireMap.clear();
     histWireMap.clear();
-    wireLocks.clear();
+    histFadeEpoch = 0;
+    histWireFadeSkips.clear();
+    trackCostCaches.clear();
+    trackVersions.clear();
     // Via
     routedViaMap.clear();       // the last layer will not be used
     routedViaMapUpper.clear();  // the first layer will not be used
-    viaLocks.clear();           // the last layer will not be used
-    viaLocksUpper.clear();      // the first layer will not be used
     histViaMap.clear();         // the last layer will not be used
+    histViaScale = 1.0;
     for (auto& layer : poorViaMap) {
         for (auto& track : layer) {
             for (auto& intvl : track) {
@@ -104,12 +145,19 @@ void RouteGrid::clear() {
 
 void RouteGrid::stash() {
     histWireMap_copy = histWireMap;
+    histFadeEpoch_copy = histFadeEpoch;
+    histWireFadeSkips_copy = histWireFadeSkips;
     histViaMap_copy = histViaMap;
+    histViaScale_copy = histViaScale;
 }
 
 void RouteGrid::reset() {
     histWireMap = histWireMap_copy;
+    histFadeEpoch = histFadeEpoch_copy;
+    histWireFadeSkips = histWireFadeSkips_copy;
+    ++trackCostEpoch;
     histViaMap = histViaMap_copy;
+    histViaScale = histViaScale_copy;
 }
 
 void RouteGrid::setUnitVioCost(double discount) {
@@ -136,7 +184,7 @@ CostT RouteGrid::getEdgeCost(const GridEdge& edge, const int netIdx) const {
 
 CostT RouteGrid::getEdgeVioCost(const GridEdge& edge, const int netIdx, bool histCost) const {
     if (edge.isVia()) {
-        auto viaType = getViaType(edge.lowerGridPoint());
+        auto viaType = getViaType(edge.lowerGridPoint(), netIdx);
         return getViaVioCost(edge.lowerGridPoint(), netIdx, histCost, viaType);
     } else if (edge.isTrackSegment()) {
         return getWireSegmentVioCost({edge}, netIdx, histCost);
@@ -177,51 +225,62 @@ unsigned RouteGrid::getViaUsageOnTopWires(const GridPoint& via, const int netIdx
     return getViaUsageOnWiresHelper(upper, netIdx, viaType->viaTopWire[upper.crossPointIdx]);
 }
 
-unsigned RouteGrid::getViaUsageOnWiresHelper(const GridPoint& gp,
-                                             const int netIdx,
-                                             const vector<vector<bool>>& viaWire) const {
-    int xSize = viaWire.size() / 2;
-    int ySize = viaWire[0].size() / 2;
+unsigned RouteGrid::getViaUsageOnWiresHelper(const GridPoint& gp, const int netIdx, const BitLUT& viaWire) const {
+    const int xSize = viaWire.xSize() / 2;
+    const int ySize = viaWire.ySize() / 2;
+    const int cpOffset = gp.crossPointIdx - ySize;  // the cross point of y = 0 in the LUT
+    const int yLow = max(0, -cpOffset);
+    const int yHigh = min(layers[gp.layerIdx].numCrossPoints() - 1 - cpOffset, viaWire.ySize() - 1);
     unsigned usageOnWires = 0;
-    for (unsigned i = max(0, gp.trackIdx - xSize); i < min(layers[gp.layerIdx].numTracks(), gp.trackIdx + xSize + 1);
-         ++i) {
-        vector<GridPoint> gps;
-        for (unsigned j = max(0, gp.crossPointIdx - ySize);
-             j < min(layers[gp.layerIdx].numCrossPoints(), gp.crossPointIdx + ySize + 1);
-             ++j) {
-            if (viaWire[i + xSize - gp.trackIdx][j + ySize - gp.crossPointIdx]) {
-                gps.emplace_back(gp.layerIdx, i, j);
-            }
-        }
-        if (gps.empty()) {
-            continue;
+    for (int i = max(0, gp.trackIdx - xSize); i < min(layers[gp.layerIdx].numTracks(), gp.trackIdx + xSize + 1); ++i) {
+        if (isWireUsedInLUTRow(gp.layerIdx, i, netIdx, viaWire, i + xSize - gp.trackIdx, cpOffset, yLow, yHigh)) {
+            ++usageOnWires;  // count # tracks violated
         }
-        const int low = gps.front().crossPointIdx;
-        const int high = gps.back().crossPointIdx;
-        const vector<int>& crossPointUsage =
-            getShortWireSegmentUsageOnOvlpWire({gps[0].layerIdx, gps[0].trackIdx, {low, high}}, netIdx);
-        for (int usage : crossPointUsage) {
-            if (usage) {
-                ++usageOnWires;  // count # tracks violated
-                break;
+    }
+    return usageOnWires;
+}
+
+bool RouteGrid::isWireUsedInLUTRow(const int layerIdx,
+                                   const int trackIdx,
+                                   const int netIdx,
+                                   const BitLUT& LUT,
+                                   const int x,
+                                   const int cpOffset,
+                                   const int yLow,
+                                   const int yHigh) const {
+    if (LUT.firstInRow(x, yLow, yHigh) < 0) return false;
+
+    // the row is tested word by word against the usage mask of the track (a LUT row spans a few cross points, i.e.,
+    // mostly a single word)
+    const uint64_t* row = LUT.row(x);
+    auto lock = readLock(TrackLockKind::WIRE, layerIdx, trackIdx);
+    const WireMap& wireMap = routedWireMap[layerIdx][trackIdx];
+    for (int w = yLow >> 6; w <= (yHigh >> 6); ++w) {
+        const int wordLow = max(yLow, w * 64);
+        const int wordHigh = min(yHigh, w * 64 + 63);
+        const uint64_t rowWord = row[w] & utils::bitops::range_mask(wordLow - w * 64, wordHigh - w * 64);
+        if (!rowWord) continue;
+        uint64_t usedMask = 0;
+        auto segments = wireMap.equal_range(wordLow + cpOffset, wordHigh + cpOffset);
+        for (auto it = segments.first; it != segments.second; ++it) {
+            if (it->numNets() - it->hasNet(netIdx) > 0) {
+                usedMask |= utils::bitops::range_mask(max(it->low - cpOffset, wordLow) - w * 64,
+                                                      min(it->high - cpOffset, wordHigh) - w * 64);
             }
         }
+        if (rowWord & usedMask) return true;
     }
-    return usageOnWires;
+    return false;
 }
 
 HistUsageT RouteGrid::getViaHistUsage(const GridPoint& via) const {
-    auto it = histViaMap[via.layerIdx][via.trackIdx].find(via.crossPointIdx);
-    if (it == histViaMap[via.layerIdx][via.trackIdx].end()) {
-        return 0.0;
-    } else {
-        return it->second;
-    }
+    return histViaMap[via.layerIdx][via.trackIdx].get(via.crossPointIdx) * histViaScale;
 }
 
-const ViaType* RouteGrid::getViaType(const GridPoint& via) const {
-    auto it = routedNonDefViaMap.find(via);
-    return (it != routedNonDefViaMap.end()) ? it->second : &cutLayers[via.layerIdx].defaultViaType();
+const ViaType* RouteGrid::getViaType(const GridPoint& via, int netIdx) const {
+    auto lock = readLock(TrackLockKind::VIA, via.layerIdx, via.trackIdx);
+    auto viaType = routedViaMap[via.layerIdx][via.trackIdx].getViaType(via.crossPointIdx, netIdx);
+    return viaType ? viaType : &cutLayers[via.layerIdx].defaultViaType();
 }
 
 unsigned RouteGrid::getViaUsageOnVias(const GridPoint& via, const int netIdx, const ViaType* viaType) const {
@@ -233,7 +292,6 @@ unsigned RouteGrid::getViaUsageOnSameLayerVias(const GridPoint& via, const int n
     if (!viaType) viaType = &cutLayers[via.layerIdx].defaultViaType();
     unsigned usageOnVias = 0;
     const GridPoint& upper = getUpper(via);
-    vector<GridPoint> viaVios;
     int xSize = viaType->mergedAllViaMetal.size() / 2;
     int ySize = viaType->mergedAllViaMetal[0].size() / 2;
     for (int i = max(0, via.trackIdx - xSize); i < min(layers[via.layerIdx].numTracks(), via.trackIdx + xSize + 1);
@@ -242,13 +300,14 @@ unsigned RouteGrid::getViaUsageOnSameLayerVias(const GridPoint& via, const int n
         int lastCP = layers[upper.layerIdx]
                          .tracks[min(layers[upper.layerIdx].numTracks() - 1, upper.trackIdx + ySize)]
                          .lowerCPIdx;
+        auto lock = readLock(TrackLockKind::VIA, via.layerIdx, i);
         auto itBegin = routedViaMap[via.layerIdx][i].lower_bound(firstCP);
         auto itEnd = routedViaMap[via.layerIdx][i].upper_bound(lastCP);
         for (auto it = itBegin; it != itEnd; ++it) {
-            if (it->second == netIdx) continue;
-            const GridPoint viaVio(via.layerIdx, i, it->first);
+            if (it->netIdx == netIdx) continue;
+            const GridPoint viaVio(via.layerIdx, i, it->crossPointIdx);
             const GridPoint upperVio = getUpper(viaVio);
-            const auto& LUT = viaType->allViaMetalNum[getViaType(viaVio)->idx];
+            const auto& LUT = viaType->allViaMetalNum[getViaType(*it, via.layerIdx)->idx];
             int xSizeVio = LUT.size() / 2;
             int ySizeVio = LUT[0].size() / 2;
             int offsetX = viaVio.trackIdx - via.trackIdx;
@@ -287,32 +346,33 @@ unsigned RouteGrid::getViaUsageOnTopLayerVias(const GridPoint& via, const int ne
 
 unsigned RouteGrid::getViaUsageOnDiffLayerViasHelper(const GridPoint& via,
                                                      const int netIdx,
-                                                     const vector<vector<bool>>& mergedAllViaVia,
-                                                     const vector<vector<vector<vector<bool>>>>& allViaVia,
+                                                     const BitLUT& mergedAllViaVia,
+                                                     const vector<BitLUTs>& allViaVia,
                                                      const ViaMapT& viaMap,
                                                      bool viaBotVia) const {
     // Note: via and viaVio are defined by their grid points in the middle layer in this function
     unsigned usageOnVias = 0;
-    int xSize = mergedAllViaVia.size() / 2;
-    int ySize = mergedAllViaVia[0].size() / 2;
+    int xSize = mergedAllViaVia.xSize() / 2;
+    int ySize = mergedAllViaVia.ySize() / 2;
     for (unsigned i = max(0, via.trackIdx - xSize); i < min(layers[via.layerIdx].numTracks(), via.trackIdx + xSize + 1);
          ++i) {
+        auto lock = readViaLock(viaMap, via.layerIdx, i);
         auto itBegin = viaMap[via.layerIdx][i].lower_bound(max(0, via.crossPointIdx - ySize));
         auto itEnd = viaMap[via.layerIdx][i].upper_bound(
             min(layers[via.layerIdx].numCrossPoints() - 1, via.crossPointIdx + ySize));
         for (auto it = itBegin; it != itEnd; ++it) {
-            if (it->second == netIdx) continue;
-            int neighCP = it->first;
-            if (mergedAllViaVia[i - via.trackIdx + xSize][neighCP - via.crossPointIdx + ySize]) {
+            if (it->netIdx == netIdx) continue;
+            int neighCP = it->crossPointIdx;
+            if (mergedAllViaVia(i - via.trackIdx + xSize, neighCP - via.crossPointIdx + ySize)) {
                 GridPoint viaVio(via.layerIdx, i, neighCP);
-                GridPoint viaVioLower = viaBotVia ? getLower(viaVio) : viaVio;
-                const auto& LUT = allViaVia[getViaType(viaVioLower)->idx][via.crossPointIdx];
-                int xSizeVio = LUT.size() / 2;
-                int ySizeVio = LUT[0].size() / 2;
+                int viaVioCutLayerIdx = viaBotVia ? via.layerIdx - 1 : via.layerIdx;
+                const auto& LUT = allViaVia[getViaType(*it, viaVioCutLayerIdx)->idx][via.crossPointIdx];
+                int xSizeVio = LUT.xSize() / 2;
+                int ySizeVio = LUT.ySize() / 2;
                 int offsetX = viaVio.trackIdx - via.trackIdx;
                 int offsetY = viaVio.crossPointIdx - via.crossPointIdx;
                 if (abs(offsetX) <= xSizeVio && abs(offsetY) <= ySizeVio &&
-                    LUT[offsetX + xSizeVio][offsetY + ySizeVio]) {
+                    LUT(offsetX + xSizeVio, offsetY + ySizeVio)) {
                     usageOnVias += 1;
                 }
             }
@@ -455,31 +515,109 @@ CostT RouteGrid::getWireSegmentCost(const TrackSegment& ts, const int netIdx) co
 
 CostT RouteGrid::getWireSegmentVioCost(const TrackSegment& ts, const int netIdx, bool histCost) const {
     CostT cost = 0;
+    int64_t wireUsage, poorWireUsage;
+    double histWireUsage;
+    bool cached = getCachedWireSegmentUsage(ts, netIdx, histCost, wireUsage, poorWireUsage, histWireUsage);
     // 1. With other wires
     // 1.1 Short
-    iterateWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl, int usage) {
-        DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost(intvl);
-        cost += unitShortVioCostDiscounted[ts.layerIdx] * usage * dist;
-    });
+    if (cached) {
+        cost += unitShortVioCostDiscounted[ts.layerIdx] * wireUsage;
+    } else {
+        iterateWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl, int usage) {
+            DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost(intvl);
+            cost += unitShortVioCostDiscounted[ts.layerIdx] * usage * dist;
+        });
+    }
     // 1.2 Space
-    cost += (unitSpaceVioCostDiscounted * getWireSegmentSpaceVioOnWires(ts, netIdx).size());
+    auto& crossPoints = costQueryBuffers().crossPoints;
+    getWireSegmentSpaceVioOnWires(ts, netIdx, crossPoints);
+    cost += (unitSpaceVioCostDiscounted * crossPoints.size());
     // 2. Short or space vio with pins/obs
-    iteratePoorWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl) {
-        DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost(intvl);
-        cost += unitShortVioCost[ts.layerIdx] * dist * setting.dbPoorWirePenaltyCoeff;
-    });
+    if (cached) {
+        cost += unitShortVioCost[ts.layerIdx] * poorWireUsage * setting.dbPoorWirePenaltyCoeff;
+    } else {
+        iteratePoorWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl) {
+            DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost(intvl);
+            cost += unitShortVioCost[ts.layerIdx] * dist * setting.dbPoorWirePenaltyCoeff;
+        });
+    }
     // 3. With vias
-    cost += (unitSpaceVioCostDiscounted * getWireSegmentUsageOnVias(ts, netIdx).size());
+    getWireSegmentUsageOnVias(ts, netIdx, crossPoints);
+    cost += (unitSpaceVioCostDiscounted * crossPoints.size());
     // 4. Hist cost
     if (histCost) {
-        iterateHistWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl, HistUsageT discountedUsage) {
-            DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost(intvl);
-            cost += unitShortVioCostDiscounted[ts.layerIdx] * discountedUsage * dist;
-        });
+        if (cached) {
+            cost += unitShortVioCostDiscounted[ts.layerIdx] * histWireUsage;
+        } else {
+            iterateHistWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl, HistUsageT discountedUsage) {
+                DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost(intvl);
+                cost += unitShortVioCostDiscounted[ts.layerIdx] * discountedUsage * dist;
+            });
+        }
     }
     return cost;
 }
 
+bool RouteGrid::getCachedWireSegmentUsage(const TrackSegment& ts,
+                                          int netIdx,
+                                          bool histCost,
+                                          int64_t& wireUsage,
+                                          int64_t& poorWireUsage,
+                                          double& histWireUsage) const {
+    if (trackCostCaches.empty()) return false;
+    auto& slot = trackCostCaches[ts.layerIdx][ts.trackIdx];
+    // without read locks (i.e., no commits overlap queries), the track stays unchanged while the stamp is up to date,
+    // so an up-to-date cache can be read without any lock
+    TrackLockT lock;
+    const TrackCostCache* cache = lockOnRead ? nullptr : slot.get();
+    if (!cache || cache->stamp.load(std::memory_order_acquire) != getTrackCostStamp(ts.layerIdx, ts.trackIdx)) {
+        // readers may rebuild the cache, which reads the maps of this track only (i.e., takes no other lock)
+        lock = writeLock(TrackLockKind::WIRE, ts.layerIdx, ts.trackIdx);
+        auto& lockedCache = slot.getOrCreate();
+        uint64_t stamp = getTrackCostStamp(ts.layerIdx, ts.trackIdx);
+        if (lockedCache.stamp.load(std::memory_order_relaxed) != stamp) {
+            buildTrackCostCache(ts.layerIdx, ts.trackIdx, lockedCache);
+            lockedCache.stamp.store(stamp, std::memory_order_release);
+        }
+        cache = &lockedCache;
+    }
+    if (cache->wire.hasNet(netIdx) || cache->poorWire.hasNet(netIdx) || (histCost && cache->histWire.hasNet(netIdx))) {
+        return false;
+    }
+    const auto& accDistCost = layers[ts.layerIdx].accCrossPointDistCost;
+    const auto& cps = ts.crossPointRange;
+    wireUsage = cache->wire.sum(cps.low, cps.high, accDistCost);
+    poorWireUsage = cache->poorWire.sum(cps.low, cps.high, accDistCost);
+    histWireUsage = histCost ? cache->histWire.sum(cps.low, cps.high, accDistCost) : 0;
+    return true;
+}
+
+void RouteGrid::buildTrackCostCache(int layerIdx, int trackIdx, TrackCostCache& cache) const {
+    const auto& accDistCost = layers[layerIdx].accCrossPointDistCost;
+    auto sortNets = [](vector<int>& nets) {
+        std::sort(nets.begin(), nets.end());
+        nets.erase(std::unique(nets.begin(), nets.end()), nets.end());
+    };
+    cache.wire.clear();
+    for (const auto& segment : routedWireMap[layerIdx][trackIdx]) {
+        cache.wire.push_back(segment.low, segment.high, segment.numNets(), accDistCost);
+        cache.wire.nets.insert(cache.wire.nets.end(), segment.nets.begin(), segment.nets.end());
+    }
+    sortNets(cache.wire.nets);
+    cache.poorWire.clear();
+    for (const auto& intvl : poorWireMap[layerIdx][trackIdx]) {
+        cache.poorWire.push_back(first(intvl.first), last(intvl.first), 1, accDistCost);
+        cache.poorWire.nets.push_back(intvl.second.netIdx);
+    }
+    sortNets(cache.poorWire.nets);
+    cache.histWire.clear();
+    for (const auto& intvl : histWireMap[layerIdx][trackIdx]) {
+        cache.histWire.push_back(first(intvl.first), last(intvl.first), getHistWireUsage(intvl.second), accDistCost);
+        cache.histWire.nets.push_back(intvl.second.netIdx);
+    }
+    sortNets(cache.histWire.nets);
+}
+
 CostT RouteGrid::getWrongWayWireSegmentVioCost(const WrongWaySegment& wws, const int netIdx, bool histCost) const {
     CostT cost = 0;
     for (int trackIdx = wws.trackRange.low; trackIdx <= wws.trackRange.high; ++trackIdx) {
@@ -488,22 +626,27 @@ CostT RouteGrid::getWrongWayWireSegmentVioCost(const WrongWaySegment& wws, const
     return cost;
 }
 
-vector<CostT> RouteGrid::getShortWireSegmentCost(const TrackSegment& ts, int netIdx) const {
+void RouteGrid::getShortWireSegmentCost(const TrackSegment& ts, int netIdx, vector<CostT>& crossPointCost) const {
     const auto& cps = ts.crossPointRange;
-    vector<CostT> crossPointCost = getShortWireSegmentVioCost(ts, netIdx);
+    getShortWireSegmentVioCost(ts, netIdx, true, crossPointCost);
     for (int cpIdx = cps.low; cpIdx <= cps.high; cpIdx++) {
         DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost({cpIdx, cpIdx});
         crossPointCost[cpIdx - cps.low] += dist;
     }
-    return crossPointCost;
 }
 
-vector<CostT> RouteGrid::getShortWireSegmentVioCost(const TrackSegment& ts, int netIdx, bool histCost) const {
+void RouteGrid::getShortWireSegmentVioCost(const TrackSegment& ts,
+                                           int netIdx,
+                                           bool histCost,
+                                           vector<CostT>& crossPointCost) const {
     const auto& cps = ts.crossPointRange;
-    vector<CostT> crossPointCost(cps.range() + 1, 0);
+    auto& buffers = costQueryBuffers();
+    crossPointCost.assign(cps.range() + 1, 0);
     // 1. With other wires and pins/obs
-    const vector<int>& routedWire = getShortWireSegmentUsageOnOvlpWire(ts, netIdx);
-    const vector<int>& poorWire = getShortWireSegmentUsageOnOvlpPoorWire(ts, netIdx);
+    vector<int>& routedWire = buffers.routedWire;
+    vector<int>& poorWire = buffers.poorWire;
+    getShortWireSegmentUsageOnOvlpWire(ts, netIdx, routedWire);
+    getShortWireSegmentUsageOnOvlpPoorWire(ts, netIdx, poorWire);
     for (int cpIdx = cps.low; cpIdx <= cps.high; cpIdx++) {
         DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost({cpIdx, cpIdx});
         int i = cpIdx - cps.low;
@@ -511,27 +654,29 @@ vector<CostT> RouteGrid::getShortWireSegmentVioCost(const TrackSegment& ts, int
                               unitShortVioCost[ts.layerIdx] * poorWire[i] * setting.dbPoorWirePenaltyCoeff) *
                              dist;
     }
-    vector<int> cpLocs = getShortWireSegmentSpaceVioOnWires(ts, netIdx);
+    vector<int>& cpLocs = buffers.crossPoints;
+    getShortWireSegmentSpaceVioOnWires(ts, netIdx, cpLocs);
     for (int cpIdx : cpLocs) {
         cpIdx = min(max(cps.low, cpIdx), cps.high);
         crossPointCost[cpIdx - cps.low] += unitSpaceVioCostDiscounted;
     }
     // 2. With vias
-    vector<int> viaLocs = getWireSegmentUsageOnVias(ts, netIdx);
+    vector<int>& viaLocs = buffers.crossPoints;
+    getWireSegmentUsageOnVias(ts, netIdx, viaLocs);
     for (int cpIdx : viaLocs) {
         cpIdx = min(max(cps.low, cpIdx), cps.high);
         crossPointCost[cpIdx - cps.low] += unitSpaceVioCostDiscounted;
     }
     // 3. Hist cost
     if (histCost) {
-        const vector<HistUsageT>& histWire = getShortWireSegmentUsageOnOvlpHistWire(ts, netIdx);
+        vector<HistUsageT>& histWire = buffers.histWire;
+        getShortWireSegmentUsageOnOvlpHistWire(ts, netIdx, histWire);
         for (int cpIdx = cps.low; cpIdx <= cps.high; cpIdx++) {
             DBU dist = layers[ts.layerIdx].getCrossPointRangeDistCost({cpIdx, cpIdx});
             crossPointCost[cpIdx - cps.low] +=
                 unitShortVioCostDiscounted[ts.layerIdx] * histWire[cpIdx - cps.low] * dist;
         }
     }
-    return crossPointCost;
 }
 
 vector<utils::IntervalT<int>> RouteGrid::getEmptyIntvl(const TrackSegment& ts, int netIdx) const {
@@ -564,92 +709,52 @@ vector<utils::IntervalT<int>> RouteGrid::getEmptyIntvl(const TrackSegment& ts, i
     return emptyIntervals;
 }
 
-vector<int> RouteGrid::getShortWireSegmentUsageOnOvlpWire(const TrackSegment& ts, int netIdx) const {
-    vector<int> crossPointUsage(ts.crossPointRange.range() + 1, 0);
+void RouteGrid::getShortWireSegmentUsageOnOvlpWire(const TrackSegment& ts,
+                                                   int netIdx,
+                                                   vector<int>& crossPointUsage) const {
+    crossPointUsage.assign(ts.crossPointRange.range() + 1, 0);
     iterateWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl, int usage) {
         for (int cpIdx = intvl.low; cpIdx <= intvl.high; cpIdx++) {
             crossPointUsage[cpIdx - ts.crossPointRange.low] += usage;
         }
     });
-    return crossPointUsage;
 }
 
-vector<int> RouteGrid::getShortWireSegmentUsageOnOvlpPoorWire(const TrackSegment& ts, int netIdx) const {
-    vector<int> crossPointUsage(ts.crossPointRange.range() + 1, 0);
+void RouteGrid::getShortWireSegmentUsageOnOvlpPoorWire(const TrackSegment& ts,
+                                                       int netIdx,
+                                                       vector<int>& crossPointUsage) const {
+    crossPointUsage.assign(ts.crossPointRange.range() + 1, 0);
     iteratePoorWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl) {
         for (int cpIdx = intvl.low; cpIdx <= intvl.high; cpIdx++) {
             ++crossPointUsage[cpIdx - ts.crossPointRange.low];
         }
     });
-    return crossPointUsage;
 }
 
-vector<HistUsageT> RouteGrid::getShortWireSegmentUsageOnOvlpHistWire(const TrackSegment& ts, int netIdx) const {
-    vector<HistUsageT> crossPointUsage(ts.crossPointRange.range() + 1, 0);
+void RouteGrid::getShortWireSegmentUsageOnOvlpHistWire(const TrackSegment& ts,
+                                                       int netIdx,
+                                                       vector<HistUsageT>& crossPointUsage) const {
+    crossPointUsage.assign(ts.crossPointRange.range() + 1, 0);
     iterateHistWireSegments(ts, netIdx, [&](const utils::IntervalT<int>& intvl, HistUsageT discountedUsage) {
         for (int cpIdx = intvl.low; cpIdx <= intvl.high; cpIdx++) {
             crossPointUsage[cpIdx - ts.crossPointRange.low] += discountedUsage;
         }
     });
-    return crossPointUsage;
 }
 
-void RouteGrid::iterateWireSegments(const TrackSegment& ts,
-                                    int netIdx,
-                                    const std::function<void(const utils::IntervalT<int>&, int)>& handle) const {
-    auto queryInterval = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
-    auto intervals = routedWireMap[ts.layerIdx][ts.trackIdx].equal_range(queryInterval);
-    for (auto it = intervals.first; it != intervals.second; ++it) {
-        auto mergedInterval = it->first & queryInterval;
-        int usage = it->second.size();
-        if (it->second.find(netIdx) != it->second.end()) {
-            --usage;
-        }
-        if (usage > 0) {
-            handle({first(mergedInterval), last(mergedInterval)}, usage);
-        }
-    }
-}
-
-void RouteGrid::iteratePoorWireSegments(const TrackSegment& ts,
-                                        int netIdx,
-                                        const std::function<void(const utils::IntervalT<int>&)>& handle) const {
-    auto queryInterval = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
-    auto intervals = poorWireMap[ts.layerIdx][ts.trackIdx].equal_range(queryInterval);
-    for (auto it = intervals.first; it != intervals.second; ++it) {
-        auto mergedInterval = it->first & queryInterval;
-        if (netIdx != it->second.netIdx) {
-            handle({first(mergedInterval), last(mergedInterval)});
-        }
-    }
-}
-
-void RouteGrid::iterateHistWireSegments(
-    const TrackSegment& ts,
-    int netIdx,
-    const std::function<void(const utils::IntervalT<int>&, HistUsageT)>& handle) const {
-    auto queryInterval = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
-    auto intervals = histWireMap[ts.layerIdx][ts.trackIdx].equal_range(queryInterval);
-    for (auto it = intervals.first; it != intervals.second; ++it) {
-        auto mergedInterval = it->first & queryInterval;
-        if (netIdx != it->second.netIdx) {
-            handle({first(mergedInterval), last(mergedInterval)}, it->second.usage);
-        }
-    }
-}
-
-vector<int> RouteGrid::getWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx) const {
-    vector<int> vioCPs;
+void RouteGrid::getWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx, vector<int>& vioCPs) const {
+    vioCPs.clear();
     const auto& cps = ts.crossPointRange;
     const auto& wireRange = layers[ts.layerIdx].wireRange;
+    auto lock = readLock(TrackLockKind::WIRE, ts.layerIdx, ts.trackIdx);
     if (wireRange[cps.low].low < 0) {
-        auto queryInterval = boost::icl::interval<int>::closed(cps.low + wireRange[cps.low].low, cps.low - 1);
-        auto intervals = routedWireMap[ts.layerIdx][ts.trackIdx].equal_range(queryInterval);
-        if (intervals.first != intervals.second) {
-            auto it = intervals.second;
+        auto segments =
+            routedWireMap[ts.layerIdx][ts.trackIdx].equal_range(cps.low + wireRange[cps.low].low, cps.low - 1);
+        if (segments.first != segments.second) {
+            auto it = segments.second;
             --it;
-            int prevEnd = last(it->first);
-            if (it->second.find(netIdx) == it->second.end() && prevEnd < cps.low) {  // no ovlp/short
+            int prevEnd = it->high;
+            if (!it->hasNet(netIdx) && prevEnd < cps.low) {  // no ovlp/short
                 for (int cpIdx = cps.low; cpIdx <= prevEnd + wireRange[prevEnd].high; ++cpIdx) {
                     vioCPs.push_back(cpIdx);
                 }
@@ -657,30 +762,29 @@ vector<int> RouteGrid::getWireSegmentSpaceVioOnWires(const TrackSegment& ts, int
         }
     }
     if (wireRange[cps.high].high > 0) {
-        auto queryInterval = boost::icl::interval<int>::closed(cps.high + 1, cps.high + wireRange[cps.high].high);
-        auto intervals = routedWireMap[ts.layerIdx][ts.trackIdx].equal_range(queryInterval);
-        if (intervals.first != intervals.second) {
-            auto it = intervals.first;
-            int nextEnd = first(it->first);
-            if (it->second.find(netIdx) == it->second.end() && nextEnd > cps.high) {  // no ovlp/short
+        auto segments =
+            routedWireMap[ts.layerIdx][ts.trackIdx].equal_range(cps.high + 1, cps.high + wireRange[cps.high].high);
+        if (segments.first != segments.second) {
+            auto it = segments.first;
+            int nextEnd = it->low;
+            if (!it->hasNet(netIdx) && nextEnd > cps.high) {  // no ovlp/short
                 for (int cpIdx = nextEnd + wireRange[nextEnd].low; cpIdx <= cps.high; ++cpIdx) {
                     vioCPs.push_back(cpIdx);
                 }
             }
         }
     }
-    return vioCPs;
 }
 
-vector<int> RouteGrid::getShortWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx) const {
-    vector<int> vioCPs;
+void RouteGrid::getShortWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx, vector<int>& vioCPs) const {
+    vioCPs.clear();
     const auto& cps = ts.crossPointRange;
     const auto& wireRange = layers[ts.layerIdx].wireRange;
-    auto queryInterval =
-        boost::icl::interval<int>::closed(cps.low + wireRange[cps.low].low, cps.high + wireRange[cps.high].high);
-    auto intervals = routedWireMap[ts.layerIdx][ts.trackIdx].equal_range(queryInterval);
-    for (auto it = intervals.first; it != intervals.second; ++it) {
-        int low = first(it->first), high = last(it->first);
+    auto lock = readLock(TrackLockKind::WIRE, ts.layerIdx, ts.trackIdx);
+    auto segments = routedWireMap[ts.layerIdx][ts.trackIdx].equal_range(cps.low + wireRange[cps.low].low,
+                                                                         cps.high + wireRange[cps.high].high);
+    for (auto it = segments.first; it != segments.second; ++it) {
+        int low = it->low, high = it->high;
         for (int cpIdx = low + wireRange[low].low; cpIdx < low; ++cpIdx) {
             if (cpIdx >= cps.low && cpIdx <= cps.high) vioCPs.push_back(cpIdx);
         }
@@ -688,11 +792,10 @@ vector<int> RouteGrid::getShortWireSegmentSpaceVioOnWires(const TrackSegment& ts
             if (cpIdx >= cps.low && cpIdx <= cps.high) vioCPs.push_back(cpIdx);
         }
     }
-    return vioCPs;
 }
 
-vector<int> RouteGrid::getWireSegmentUsageOnVias(const TrackSegment& ts, int netIdx) const {
-    vector<int> viaCPs;
+void RouteGrid::getWireSegmentUsageOnVias(const TrackSegment& ts, int netIdx, vector<int>& viaCPs) const {
+    viaCPs.clear();
     if ((ts.layerIdx + 1) != layers.size()) {
         // top vias
         getWireSegmentUsageOnVias(ts, netIdx, layers[ts.layerIdx].mergedWireTopVia, routedViaMap, false, viaCPs);
@@ -701,42 +804,39 @@ vector<int> RouteGrid::getWireSegmentUsageOnVias(const TrackSegment& ts, int net
         // bot vias
         getWireSegmentUsageOnVias(ts, netIdx, layers[ts.layerIdx].mergedWireBotVia, routedViaMapUpper, true, viaCPs);
     }
-    return viaCPs;
 }
 
 void RouteGrid::getWireSegmentUsageOnVias(const TrackSegment& ts,
                                           int netIdx,
-                                          const vector<vector<vector<bool>>>& wireVia,
+                                          const BitLUTs& wireVia,
                                           const ViaMapT& viaMap,
                                           bool wireBotVia,
                                           vector<int>& viaCPs) const {
     int layerIdx = ts.layerIdx;
     const MetalLayer& layer = layers[layerIdx];
-    const int xSize = wireVia[0].size() / 2;
-    const int ySize = max(wireVia[ts.crossPointRange.low][0].size(), wireVia[ts.crossPointRange.high][0].size()) / 2;
+    const int xSize = wireVia[0].xSize() / 2;
+    const int ySize = max(wireVia[ts.crossPointRange.low].ySize(), wireVia[ts.crossPointRange.high].ySize()) / 2;
 
     for (unsigned i = max(0, ts.trackIdx - xSize); i < min(layer.numTracks(), ts.trackIdx + xSize + 1); ++i) {
+        auto lock = readViaLock(viaMap, layerIdx, i);
         auto itBegin = viaMap[layerIdx][i].lower_bound(ts.crossPointRange.low - ySize);
         auto itEnd = viaMap[layerIdx][i].upper_bound(ts.crossPointRange.high + ySize);
 
         for (auto it = itBegin; it != itEnd; ++it) {
-            if (it->second == netIdx) continue;
-            const int viaCP = it->first;
+            if (it->netIdx == netIdx) continue;
+            const int viaCP = it->crossPointIdx;
             GridPoint via(ts.layerIdx, i, viaCP);
-            const auto& viaWire =
-                wireBotVia ? getViaType(getLower(via))->viaTopWire[viaCP] : getViaType(via)->viaBotWire[viaCP];
-            const int viaWireXSize = viaWire.size() / 2;
-            const int viaWireYSize = viaWire[0].size() / 2;
+            const auto& viaWire = wireBotVia ? getViaType(*it, layerIdx - 1)->viaTopWire[viaCP]
+                                             : getViaType(*it, layerIdx)->viaBotWire[viaCP];
+            const int viaWireXSize = viaWire.xSize() / 2;
+            const int viaWireYSize = viaWire.ySize() / 2;
             const int offsetX = ts.trackIdx - via.trackIdx;
             if (abs(offsetX) > viaWireXSize) continue;
-            for (unsigned j = max(ts.crossPointRange.low, viaCP - viaWireYSize);
-                 j <= min(ts.crossPointRange.high, viaCP + viaWireYSize);
-                 ++j) {
-                const int offsetY = j - via.crossPointIdx;
-                if (abs(offsetY) <= viaWireYSize && viaWire[offsetX + viaWireXSize][offsetY + viaWireYSize]) {
-                    viaCPs.push_back(j);
-                }
-            }
+            const int offsetY = viaWireYSize - viaCP;  // from cross point to y in the LUT
+            viaWire.forEachInRow(offsetX + viaWireXSize,
+                                 max(ts.crossPointRange.low, viaCP - viaWireYSize) + offsetY,
+                                 min(ts.crossPointRange.high, viaCP + viaWireYSize) + offsetY,
+                                 [&](int y) { viaCPs.push_back(y - offsetY); });
         }
     }
 }
@@ -777,35 +877,69 @@ void RouteGrid::useEdge(const GridEdge& edge, int netIdx) {
     }
 }
 
-void RouteGrid::markViaType(const GridPoint& via, const ViaType* viaType) {
-    viaTypeLock.lock();
-    if (viaType->idx == cutLayers[via.layerIdx].defaultViaType().idx) {
-        routedNonDefViaMap.erase(via);
-    } else {
-        routedNonDefViaMap[via] = viaType;
+void RouteGrid::markViaType(const GridPoint& via, int netIdx, const ViaType* viaType) {
+    {
+        auto lock = writeLock(TrackLockKind::VIA, via.layerIdx, via.trackIdx);
+        routedViaMap[via.layerIdx][via.trackIdx].setViaType(via.crossPointIdx, netIdx, viaType);
     }
-    viaTypeLock.unlock();
+    auto upper = getUpper(via);
+    auto lock = writeLock(TrackLockKind::VIA_UPPER, upper.layerIdx, upper.trackIdx);
+    routedViaMapUpper[upper.layerIdx][upper.trackIdx].setViaType(upper.crossPointIdx, netIdx, viaType);
 }
 
 void RouteGrid::useVia(const GridPoint& via, int netIdx, ViaMapT& netsOnVias) {
-    netsOnVias[via.layerIdx][via.trackIdx].emplace(via.crossPointIdx, netIdx);
+    netsOnVias[via.layerIdx][via.trackIdx].insert(via.crossPointIdx, netIdx);
 }
 
 void RouteGrid::useVia(const GridPoint& via, int netIdx) {
-    viaLocks[via.layerIdx][via.trackIdx].lock();
-    useVia(via, netIdx, routedViaMap);
-    viaLocks[via.layerIdx][via.trackIdx].unlock();
+    {
+        auto lock = writeLock(TrackLockKind::VIA, via.layerIdx, via.trackIdx);
+        useVia(via, netIdx, routedViaMap);
+    }
     auto upper = getUpper(via);
-    viaLocksUpper[upper.layerIdx][upper.trackIdx].lock();
+    auto lock = writeLock(TrackLockKind::VIA_UPPER, upper.layerIdx, upper.trackIdx);
     useVia(upper, netIdx, routedViaMapUpper);
-    viaLocksUpper[upper.layerIdx][upper.trackIdx].unlock();
+}
+
+namespace {
+// sort vias and call handle(layerIdx, trackIdx, crossPointIdxs) for each track
+void iterateViasByTrack(vector<GridPoint>& vias, const std::function<void(int, int, const vector<int>&)>& handle) {
+    std::sort(vias.begin(), vias.end(), [](const GridPoint& lhs, const GridPoint& rhs) {
+        return std::tie(lhs.layerIdx, lhs.trackIdx, lhs.crossPointIdx) <
+               std::tie(rhs.layerIdx, rhs.trackIdx, rhs.crossPointIdx);
+    });
+    vector<int> crossPointIdxs;
+    for (int i = 0, j = 0; i < vias.size(); i = j) {
+        crossPointIdxs.clear();
+        for (j = i; j < vias.size() && vias[j].layerIdx == vias[i].layerIdx && vias[j].trackIdx == vias[i].trackIdx;
+             ++j) {
+            crossPointIdxs.push_back(vias[j].crossPointIdx);
+        }
+        handle(vias[i].layerIdx, vias[i].trackIdx, crossPointIdxs);
+    }
+}
+}  // namespace
+
+void RouteGrid::useVias(vector<GridPoint>& vias, int netIdx) {
+    vector<GridPoint> uppers;
+    uppers.reserve(vias.size());
+    for (const auto& via : vias) {
+        uppers.push_back(getUpper(via));
+    }
+    iterateViasByTrack(vias, [&](int layerIdx, int trackIdx, const vector<int>& crossPointIdxs) {
+        auto lock = writeLock(TrackLockKind::VIA, layerIdx, trackIdx);
+        routedViaMap[layerIdx][trackIdx].insert(crossPointIdxs, netIdx);
+    });
+    iterateViasByTrack(uppers, [&](int layerIdx, int trackIdx, const vector<int>& crossPointIdxs) {
+        auto lock = writeLock(TrackLockKind::VIA_UPPER, layerIdx, trackIdx);
+        routedViaMapUpper[layerIdx][trackIdx].insert(crossPointIdxs, netIdx);
+    });
 }
 
 void RouteGrid::useWireSegment(const TrackSegment& ts, int netIdx) {
-    auto iclRange = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
-    wireLocks[ts.layerIdx][ts.trackIdx].lock();
-    routedWireMap[ts.layerIdx][ts.trackIdx].add({iclRange, {netIdx}});
-    wireLocks[ts.layerIdx][ts.trackIdx].unlock();
+    auto lock = writeLock(TrackLockKind::WIRE, ts.layerIdx, ts.trackIdx);
+    routedWireMap[ts.layerIdx][ts.trackIdx].add(ts.crossPointRange.low, ts.crossPointRange.high, netIdx);
+    touchTrack(ts.layerIdx, ts.trackIdx);
 }
 
 void RouteGrid::useWrongWayWireSegment(const WrongWaySegment& wws, int netIdx) {
@@ -817,17 +951,43 @@ void RouteGrid::useWrongWayWireSegment(const WrongWaySegment& wws, int netIdx) {
 void RouteGrid::usePoorWireSegment(const TrackSegment& ts, int netIdx) {
     auto iclRange = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
     poorWireMap[ts.layerIdx][ts.trackIdx].add({iclRange, netIdx});
+    ++trackCostEpoch;
 }
 
 void RouteGrid::useHistWireSegment(const TrackSegment& ts, int netIdx, HistUsageT usage) {
     auto iclRange = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
-    histWireMap[ts.layerIdx][ts.trackIdx].add({iclRange, {netIdx, usage}});
+    fadeOverlappedHistWires(ts.layerIdx, ts.trackIdx, iclRange);
+    histWireMap[ts.layerIdx][ts.trackIdx].add({iclRange, {netIdx, usage, histFadeEpoch}});
+    ++trackCostEpoch;
 }
 
 void RouteGrid::useHistWireSegments(const GridBoxOnLayer& gb, int netIdx, HistUsageT usage) {
     auto iclRange = boost::icl::interval<int>::closed(gb.crossPointRange.low, gb.crossPointRange.high);
     for (int trackIdx = gb.trackRange.low; trackIdx <= gb.trackRange.high; ++trackIdx) {
-        histWireMap[gb.layerIdx][trackIdx].add({iclRange, {netIdx, usage}});
+        fadeOverlappedHistWires(gb.layerIdx, trackIdx, iclRange);
+        histWireMap[gb.layerIdx][trackIdx].add({iclRange, {netIdx, usage, histFadeEpoch}});
+    }
+    ++trackCostEpoch;
+}
+
+HistUsageT RouteGrid::getHistWireUsage(const HistWire& histWire) const {
+    int numFades = histFadeEpoch - histWire.epoch;
+    if (numFades > 0 && histWire.netIdx >= 0 && histWire.netIdx < int(histWireFadeSkips.size())) {
+        const auto& skips = histWireFadeSkips[histWire.netIdx];
+        numFades -= skips.end() - std::upper_bound(skips.begin(), skips.end(), histWire.epoch);
+    }
+    // fade one by one, which is the same as fading in place at each epoch
+    HistUsageT usage = histWire.usage;
+    for (int i = 0; i < numFades; ++i) usage *= setting.rrrFadeCoeff;
+    return usage;
+}
+
+void RouteGrid::fadeOverlappedHistWires(int layerIdx, int trackIdx, const boost::icl::interval<int>::type& iclRange) {
+    auto intervals = histWireMap[layerIdx][trackIdx].equal_range(iclRange);
+    for (auto it = intervals.first; it != intervals.second; ++it) {
+        auto& histWire = it->second;
+        histWire.usage = getHistWireUsage(histWire);
+        histWire.epoch = histFadeEpoch;
     }
 }
 
@@ -906,34 +1066,39 @@ void RouteGrid::removeEdge(const GridEdge& edge, int netIdx) {
 }
 
 void RouteGrid::removeVia(const GridPoint& via, int netIdx, ViaMapT& viaMap) {
-    unsigned usage = 0;
-    std::pair<std::multimap<int, int>::const_iterator, std::multimap<int, int>::const_iterator> itRange =
-        viaMap[via.layerIdx][via.trackIdx].equal_range(via.crossPointIdx);
-    for (std::multimap<int, int>::const_iterator it = itRange.first; it != itRange.second; ++it) {
-        if (it->second == netIdx) {
-            viaMap[via.layerIdx][via.trackIdx].erase(it);
-            break;
-        }
-    }
+    viaMap[via.layerIdx][via.trackIdx].erase(via.crossPointIdx, netIdx);
 }
 
 void RouteGrid::removeVia(const GridPoint& via, int netIdx) {
-    viaLocks[via.layerIdx][via.trackIdx].lock();
-    removeVia(via, netIdx, routedViaMap);
-    viaLocks[via.layerIdx][via.trackIdx].unlock();
-    viaTypeLock.lock();
-    routedNonDefViaMap.erase(via);
-    viaTypeLock.unlock();
-    viaLocksUpper[via.layerIdx][via.trackIdx].lock();
-    removeVia(getUpper(via), netIdx, routedViaMapUpper);
-    viaLocksUpper[via.layerIdx][via.trackIdx].unlock();
+    {
+        auto lock = writeLock(TrackLockKind::VIA, via.layerIdx, via.trackIdx);
+        removeVia(via, netIdx, routedViaMap);
+    }
+    auto upper = getUpper(via);
+    auto lock = writeLock(TrackLockKind::VIA_UPPER, upper.layerIdx, upper.trackIdx);
+    removeVia(upper, netIdx, routedViaMapUpper);
+}
+
+void RouteGrid::removeVias(vector<GridPoint>& vias, int netIdx) {
+    vector<GridPoint> uppers;
+    uppers.reserve(vias.size());
+    for (const auto& via : vias) {
+        uppers.push_back(getUpper(via));
+    }
+    iterateViasByTrack(vias, [&](int layerIdx, int trackIdx, const vector<int>& crossPointIdxs) {
+        auto lock = writeLock(TrackLockKind::VIA, layerIdx, trackIdx);
+        routedViaMap[layerIdx][trackIdx].erase(crossPointIdxs, netIdx);
+    });
+    iterateViasByTrack(uppers, [&](int layerIdx, int trackIdx, const vector<int>& crossPointIdxs) {
+        auto lock = writeLock(TrackLockKind::VIA_UPPER, layerIdx, trackIdx);
+        routedViaMapUpper[layerIdx][trackIdx].erase(crossPointIdxs, netIdx);
+    });
 }
 
 void RouteGrid::removeWireSegment(const TrackSegment& ts, int netIdx) {
-    auto queryInterval = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
-    wireLocks[ts.layerIdx][ts.trackIdx].lock();
-    routedWireMap[ts.layerIdx][ts.trackIdx].subtract({queryInterval, {netIdx}});
-    wireLocks[ts.layerIdx][ts.trackIdx].unlock();
+    auto lock = writeLock(TrackLockKind::WIRE, ts.layerIdx, ts.trackIdx);
+    routedWireMap[ts.layerIdx][ts.trackIdx].subtract(ts.crossPointRange.low, ts.crossPointRange.high, netIdx);
+    touchTrack(ts.layerIdx, ts.trackIdx);
 }
 
 void RouteGrid::removeWrongWayWireSegment(const WrongWaySegment& wws, int netIdx) {
@@ -992,11 +1157,10 @@ void RouteGrid::getAllWireUsage(const vector<int>& buckets,
     wireUsageLength.assign(buckets.size(), 0);
     for (int layerIdx = 0; layerIdx < getLayerNum(); ++layerIdx) {
         for (const auto& track : routedWireMap[layerIdx]) {
-            for (const auto& intvlUsage : track) {
-                const auto& intvl = intvlUsage.first;
-                int usage = intvlUsage.second.size();
-                int numGrids = (last(intvl) - first(intvl) + 1);
-                DBU dist = layers[layerIdx].getCrossPointRangeDistCost({first(intvl), last(intvl)});
+            for (const auto& segment : track) {
+                int usage = segment.numNets();
+                int numGrids = (segment.high - segment.low + 1);
+                DBU dist = layers[layerIdx].getCrossPointRangeDistCost({segment.low, segment.high});
                 int bucketIdx = buckets.size() - 1;
                 while (buckets[bucketIdx] > usage) --bucketIdx;
                 wireUsageGrid[bucketIdx] += numGrids;
@@ -1011,10 +1175,9 @@ void RouteGrid::getNetWireVioUsage(std::unordered_map<int, int>& via_usage,
                                    std::unordered_map<int, std::set<int>>& layer_usage) {
     for (int layer_idx = 0; layer_idx < getLayerNum(); ++layer_idx) {
         for (const auto& track : routedWireMap[layer_idx]) {
-            for (const auto& usage : track) {
-                const auto& intval = usage.first;
-                for (int net_idx : usage.second) {
-                    DBU dist = layers.at(layer_idx).getCrossPointRangeDist({first(intval), last(intval)});
+            for (const auto& segment : track) {
+                for (int net_idx : segment.nets) {
+                    DBU dist = layers.at(layer_idx).getCrossPointRangeDist({segment.low, segment.high});
                     wire_usage_length[net_idx] = dist / float(layers[1].pitch);
                     layer_usage[net_idx].insert(layer_idx);
                 }
@@ -1025,7 +1188,7 @@ void RouteGrid::getNetWireVioUsage(std::unordered_map<int, int>& via_usage,
     for (unsigned layerIdx = 0; (layerIdx + 1) < getLayerNum(); ++layerIdx) {
         for (const auto& track : routedViaMap[layerIdx]) {
             for ( const auto& usage: track) {
-                ++via_usage[usage.second];
+                ++via_usage[usage.netIdx];
             }
         }
     }
@@ -1037,7 +1200,7 @@ void RouteGrid::getAllViaUsage(const vector<int>& buckets, const ViaMapT& viaMap
         for (const auto& track : viaMap[layerIdx]) {
             std::unordered_map<int, int> posUsages;
             for (const auto& via : track) {
-                ++posUsages[via.first];
+                ++posUsages[via.crossPointIdx];
             }
             for (const auto& usage : posUsages) {
                 ++viaUsage[usage.second];
@@ -1116,14 +1279,14 @@ void RouteGrid::getAllViaVio(vector<int>& sameLayerViaVios,
     poorVia.assign(getLayerNum() - 1, 0);
     for (unsigned layerIdx = 0; (layerIdx + 1) != getLayerNum(); ++layerIdx) {
         for (unsigned trackIdx = 0; trackIdx != layers[layerIdx].numTracks(); ++trackIdx) {
-            for (const std::pair<int, int>& p : routedViaMap[layerIdx][trackIdx]) {
-                GridPoint via(layerIdx, trackIdx, p.first);
-                const ViaType* viaType = getViaType(via);
-                sameLayerViaVios[layerIdx] += getViaUsageOnSameLayerVias(via, p.second, viaType);
-                viaTopViaVios[layerIdx] += getViaUsageOnTopLayerVias(via, p.second, viaType);
-                viaBotWireVios[layerIdx] += getViaUsageOnBotWires(via, p.second, viaType);
-                viaTopWireVios[layerIdx] += getViaUsageOnTopWires(via, p.second, viaType);
-                if (getViaPoorness(via, p.second) == ViaPoorness::Poor) {
+            for (const auto& p : routedViaMap[layerIdx][trackIdx]) {
+                GridPoint via(layerIdx, trackIdx, p.crossPointIdx);
+                const ViaType* viaType = getViaType(p, layerIdx);
+                sameLayerViaVios[layerIdx] += getViaUsageOnSameLayerVias(via, p.netIdx, viaType);
+                viaTopViaVios[layerIdx] += getViaUsageOnTopLayerVias(via, p.netIdx, viaType);
+                viaBotWireVios[layerIdx] += getViaUsageOnBotWires(via, p.netIdx, viaType);
+                viaTopWireVios[layerIdx] += getViaUsageOnTopWires(via, p.netIdx, viaType);
+                if (getViaPoorness(via, p.netIdx) == ViaPoorness::Poor) {
                     ++poorVia[layerIdx];
                 }
             }
@@ -1137,13 +1300,12 @@ void RouteGrid::getAllWireShortVio(vector<int>& shortNum, vector<DBU>& shortLen)
     shortLen.assign(getLayerNum(), 0.0);
     for (int layerIdx = 0; layerIdx < getLayerNum(); ++layerIdx) {
         for (const auto& track : routedWireMap[layerIdx]) {
-            for (const auto& intvlUsage : track) {
-                const auto& intvl = intvlUsage.first;
-                int usage = intvlUsage.second.size();
+            for (const auto& segment : track) {
+                int usage = segment.numNets();
                 if (usage > 1) {
                     shortNum[layerIdx] += (usage - 1);
                     shortLen[layerIdx] +=
-                        (usage - 1) * layers[layerIdx].getCrossPointRangeDistCost({first(intvl), last(intvl)});
+                        (usage - 1) * layers[layerIdx].getCrossPointRangeDistCost({segment.low, segment.high});
                 }
             }
         }
@@ -1155,11 +1317,9 @@ void RouteGrid::getAllPoorWire(vector<int>& num, vector<DBU>& len) const {
     len.assign(getLayerNum(), 0.0);
     for (int layerIdx = 0; layerIdx < getLayerNum(); ++layerIdx) {
         for (int trackIdx = 0; trackIdx < routedWireMap[layerIdx].size(); ++trackIdx) {
-            for (const auto& intvlUsage : routedWireMap[layerIdx][trackIdx]) {
-                const auto& intvl = intvlUsage.first;
-                int usage = intvlUsage.second.size();
-                iteratePoorWireSegments({layerIdx, trackIdx, {first(intvl), last(intvl)}},
-                                        *intvlUsage.second.begin(),
+            for (const auto& segment : routedWireMap[layerIdx][trackIdx]) {
+                iteratePoorWireSegments({layerIdx, trackIdx, {segment.low, segment.high}},
+                                        segment.nets.front(),
                                         [&](const utils::IntervalT<int>& poorIntvl) {
                                             ++num[layerIdx];
                                             len[layerIdx] += layers[layerIdx].getCrossPointRangeDistCost(poorIntvl);
@@ -1173,11 +1333,10 @@ void RouteGrid::getAllWireSpaceVio(vector<int>& spaceVioNum) const {
     spaceVioNum.assign(getLayerNum(), 0);
     for (int layerIdx = 0; layerIdx < getLayerNum(); ++layerIdx) {
         for (int trackIdx = 0; trackIdx != layers[layerIdx].numTracks(); ++trackIdx) {
-            for (const auto& intvlUsage : routedWireMap[layerIdx][trackIdx]) {
-                for (int netIdx : intvlUsage.second) {
-                    const auto& intvl = intvlUsage.first;
+            for (const auto& segment : routedWireMap[layerIdx][trackIdx]) {
+                for (int netIdx : segment.nets) {
                     auto vioCPs =
-                        getWireSegmentSpaceVioOnWires({layerIdx, trackIdx, {first(intvl), last(intvl)}}, netIdx);
+                        getWireSegmentSpaceVioOnWires({layerIdx, trackIdx, {segment.low, segment.high}}, netIdx);
                     spaceVioNum[layerIdx] += vioCPs.size();
                 }
             }
@@ -1284,17 +1443,16 @@ void RouteGrid::addHistCost() {
 void RouteGrid::addWireHistCost() {
     for (int layerIdx = 0; layerIdx < getLayerNum(); ++layerIdx) {
         for (int trackIdx = 0; trackIdx < layers[layerIdx].numTracks(); ++trackIdx) {
-            for (const auto& intvlUsage : routedWireMap[layerIdx][trackIdx]) {
-                const auto& intvl = intvlUsage.first;
-                TrackSegment ts{layerIdx, trackIdx, {first(intvl), last(intvl)}};
-                int usage = intvlUsage.second.size();
+            for (const auto& segment : routedWireMap[layerIdx][trackIdx]) {
+                TrackSegment ts{layerIdx, trackIdx, {segment.low, segment.high}};
+                int usage = segment.numNets();
                 if (usage > 1) {
                     useHistWireSegment(ts, OBS_NET_IDX, 1.0);
                 }
-                for (int netIdx : intvlUsage.second) {
+                for (int netIdx : segment.nets) {
                     vector<int> viaLocs = getWireSegmentUsageOnVias(ts, netIdx);
                     for (int cpIdx : viaLocs) {
-                        cpIdx = min(max(first(intvl), cpIdx), last(intvl));
+                        cpIdx = min(max(segment.low, cpIdx), segment.high);
                         useHistWireSegment({layerIdx, trackIdx, {cpIdx, cpIdx}}, OBS_NET_IDX, 1.0);
                     }
                 }
@@ -1307,12 +1465,12 @@ void RouteGrid::addWireHistCost() {
 void RouteGrid::addViaHistCost() {
     for (unsigned layerIdx = 0; (layerIdx + 1) != getLayerNum(); ++layerIdx) {
         for (unsigned trackIdx = 0; trackIdx != layers[layerIdx].numTracks(); ++trackIdx) {
-            for (const std::pair<int, int>& p : routedViaMap[layerIdx][trackIdx]) {
-                GridPoint via(layerIdx, trackIdx, p.first);
-                if (getViaUsageOnVias(via, p.second, getViaType(via))) {  // ||
-                    // getViaUsageOnBotWires(via, p.second) > 0 ||
-                    // getViaUsageOnTopWires(via, p.second)) {
-                    histViaMap[layerIdx][trackIdx][p.first] += 1.0;
+            for (const auto& p : routedViaMap[layerIdx][trackIdx]) {
+                GridPoint via(layerIdx, trackIdx, p.crossPointIdx);
+                if (getViaUsageOnVias(via, p.netIdx, getViaType(p, layerIdx))) {  // ||
+                    // getViaUsageOnBotWires(via, p.netIdx) > 0 ||
+                    // getViaUsageOnTopWires(via, p.netIdx)) {
+                    histViaMap[layerIdx][trackIdx].add(p.crossPointIdx, 1.0 / histViaScale);
                 }
             }
         }
@@ -1323,24 +1481,25 @@ void RouteGrid::fadeHistCost(const vector<int>& exceptedNets) {
     if (setting.dbVerbose >= +db::VerboseLevelT::MIDDLE) {
         printlog("Fade hist cost by", setting.rrrFadeCoeff, "...");
     }
-    std::unordered_set<int> exceptedNetSet;
-    for (int netIdx : exceptedNets) exceptedNetSet.insert(netIdx);
-    std::map<CostT, int> histWireUsage, histViaUsage;
-    for (int layerIdx = 0; layerIdx < getLayerNum(); ++layerIdx) {
-        for (int trackIdx = 0; trackIdx < layers[layerIdx].numTracks(); ++trackIdx) {
-            // wire
-            for (auto& intvl : histWireMap[layerIdx][trackIdx]) {
-                auto& histWire = intvl.second;
-                if (histWire.netIdx == OBS_NET_IDX || exceptedNetSet.find(histWire.netIdx) == exceptedNetSet.end()) {
-                    histWire.usage *= setting.rrrFadeCoeff;
-                }
-            }
-            // via
-            for (auto& p : histViaMap[layerIdx][trackIdx]) {
-                p.second *= setting.rrrFadeCoeff;
-            }
+    ++trackCostEpoch;
+    // wire (lazily)
+    ++histFadeEpoch;
+    for (int netIdx : exceptedNets) {
+        if (netIdx >= int(histWireFadeSkips.size())) histWireFadeSkips.resize(netIdx + 1);
+        histWireFadeSkips[netIdx].push_back(histFadeEpoch);
+    }
+    // via (lazily)
+    histViaScale *= setting.rrrFadeCoeff;
+    if (histViaScale < histViaCompactScale) compactHistVias();
+}
+
+void RouteGrid::compactHistVias() {
+    for (auto& layer : histViaMap) {
+        for (auto& track : layer) {
+            track.scale(histViaScale, histViaCompactEps);
         }
     }
+    histViaScale = 1.0;
 }
 
 void RouteGrid::statHistCost() const {
@@ -1350,11 +1509,11 @@ void RouteGrid::statHistCost() const {
             for (int trackIdx = 0; trackIdx < layers[layerIdx].numTracks(); ++trackIdx) {
                 // wire
                 for (auto& intvl : histWireMap[layerIdx][trackIdx]) {
-                    ++histWireUsage[intvl.second.usage];
+                    ++histWireUsage[getHistWireUsage(intvl.second)];
                 }
                 // via
                 for (auto& p : histViaMap[layerIdx][trackIdx]) {
-                    ++histViaUsage[p.second];
+                    ++histViaUsage[p.second * histViaScale];
                 }
             }
         }
@@ -2,20 +2,17 @@
 
 #include "LayerList.h"
 #include "Net.h"
+#include "HistViaMap.h"
 #include "Setting.h"
+#include "TrackCostCache.h"
+#include "ViaMap.h"
+#include "WireMap.h"
 
 namespace db {
 
 class ViaData;
 
 using CostT = double;
-using HistUsageT = double;
-
-struct mutex_wrapper : std::mutex {
-    mutex_wrapper() = default;
-    mutex_wrapper(mutex_wrapper const&) noexcept : std::mutex() {}
-    bool operator==(mutex_wrapper const& other) noexcept { return this == &other; }
-};
 
 // net index
 // a valid net idx >= 0
@@ -38,14 +35,19 @@ public:
 
 inline bool operator==(const PoorWire& lhs, const PoorWire& rhs) { return lhs.netIdx == rhs.netIdx; }
 
+// usage is the one at fade epoch "epoch", and faded lazily on read (see RouteGrid::getHistWireUsage)
+// the overlapped hist wires are brought to the current epoch before merging, so both sides of += share the epoch
 class HistWire {
 public:
     int netIdx;
     HistUsageT usage;
+    int epoch;
 
-    HistWire() : netIdx(NULL_NET_IDX), usage(0.0) {}
-    HistWire(int netIndex, HistUsageT histUsage) : netIdx(netIndex), usage(histUsage) {}
+    HistWire() : netIdx(NULL_NET_IDX), usage(0.0), epoch(0) {}
+    HistWire(int netIndex, HistUsageT histUsage, int fadeEpoch)
+        : netIdx(netIndex), usage(histUsage), epoch(fadeEpoch) {}
     HistWire& operator+=(const HistWire& rhs) {
+        epoch = rhs.epoch;
         if (rhs.netIdx == OBS_NET_IDX) {
             // for "normal" hist cost
             netIdx = OBS_NET_IDX;
@@ -62,19 +64,20 @@ public:
 };
 
 inline bool operator==(const HistWire& lhs, const HistWire& rhs) {
-    return lhs.netIdx == rhs.netIdx && lhs.usage == rhs.usage;
+    return lhs.netIdx == rhs.netIdx && lhs.usage == rhs.usage && lhs.epoch == rhs.epoch;
 }
 
 class RouteGrid : public LayerList {
 public:
-    using ViaMapT = vector<vector<std::multimap<int, int>>>;
-    using NDViaMapT = std::unordered_map<GridPoint, const ViaType*>;
+    using ViaMapT = vector<vector<ViaMap>>;
 
     void init();
     void clear();
     void stash();
     void reset();
     void setUnitVioCost(double discount = 1.0);
+    // lock tracks on read when queries may overlap commits of other nets (e.g., DAG scheduling)
+    void setLockOnRead(bool lock) { lockOnRead = lock; }
 
     // Get unit cost
     inline CostT getUnitViaCost() const { return unitViaCost; }
@@ -102,17 +105,30 @@ public:
     unsigned getViaUsageOnTopLayerVias(const GridPoint& via, const int netIdx, const ViaType* viaType = nullptr) const;
     unsigned getViaUsageOnDiffLayerViasHelper(const GridPoint& gp,
                                               const int netIdx,
-                                              const vector<vector<bool>>& mergedAllViaVia,
-                                              const vector<vector<vector<vector<bool>>>>& allViaVia,
+                                              const BitLUT& mergedAllViaVia,
+                                              const vector<BitLUTs>& allViaVia,
                                               const ViaMapT& viaMap,
                                               bool viaBotVia) const;
-    const ViaType* getViaType(const GridPoint& via) const;
+    const ViaType* getViaType(const GridPoint& via, int netIdx) const;
+    const ViaType* getViaType(const ViaMap::Via& via, int cutLayerIdx) const {
+        return via.viaType ? via.viaType : &cutLayers[cutLayerIdx].defaultViaType();
+    }
     // 1.2 via on wire
     unsigned getViaUsageOnWires(const GridPoint& via, const int netIdx, const ViaType* viaType = nullptr) const;
     unsigned getViaUsageOnWiresPost(const GridPoint& via, const int netIdx, const ViaType* viaType = nullptr) const;
     unsigned getViaUsageOnBotWires(const GridPoint& via, const int netIdx, const ViaType* viaType = nullptr) const;
     unsigned getViaUsageOnTopWires(const GridPoint& via, const int netIdx, const ViaType* viaType = nullptr) const;
-    unsigned getViaUsageOnWiresHelper(const GridPoint& gp, const int netIdx, const vector<vector<bool>>& viaWire) const;
+    unsigned getViaUsageOnWiresHelper(const GridPoint& gp, const int netIdx, const BitLUT& viaWire) const;
+    // whether any cross point y in [yLow, yHigh] of row x of the LUT (i.e., cross point y + cpOffset of the track) is
+    // used by the wires of other nets
+    bool isWireUsedInLUTRow(const int layerIdx,
+                            const int trackIdx,
+                            const int netIdx,
+                            const BitLUT& LUT,
+                            const int x,
+                            const int cpOffset,
+                            const int yLow,
+                            const int yHigh) const;
     // 1.3 poor via
     enum class ViaPoorness { Poor, Nondefault, Good };
     ViaPoorness getViaPoorness(const GridPoint& via, int netIdx) const;
@@ -130,32 +146,111 @@ public:
     CostT getWireSegmentCost(const TrackSegment& ts, const int netIdx) const;
     CostT getWireSegmentVioCost(const TrackSegment& ts, const int netIdx, bool histCost = true) const;
     CostT getWrongWayWireSegmentVioCost(const WrongWaySegment& wws, const int netIdx, bool histCost) const;
-    vector<CostT> getShortWireSegmentCost(const TrackSegment& ts, int netIdx) const;
-    vector<CostT> getShortWireSegmentVioCost(const TrackSegment& ts, int netIdx, bool histCost = true) const;
+    // the overloads with an output vector reuse its capacity, so that they do not allocate when called repeatedly
+    vector<CostT> getShortWireSegmentCost(const TrackSegment& ts, int netIdx) const {
+        vector<CostT> crossPointCost;
+        getShortWireSegmentCost(ts, netIdx, crossPointCost);
+        return crossPointCost;
+    }
+    void getShortWireSegmentCost(const TrackSegment& ts, int netIdx, vector<CostT>& crossPointCost) const;
+    vector<CostT> getShortWireSegmentVioCost(const TrackSegment& ts, int netIdx, bool histCost = true) const {
+        vector<CostT> crossPointCost;
+        getShortWireSegmentVioCost(ts, netIdx, histCost, crossPointCost);
+        return crossPointCost;
+    }
+    void getShortWireSegmentVioCost(const TrackSegment& ts,
+                                    int netIdx,
+                                    bool histCost,
+                                    vector<CostT>& crossPointCost) const;
     vector<utils::IntervalT<int>> getEmptyIntvl(const TrackSegment& ts, int netIdx) const;
     // 2.1 wire on wires
-    vector<int> getShortWireSegmentUsageOnOvlpWire(const TrackSegment& ts, int netIdx) const;
-    vector<int> getShortWireSegmentUsageOnOvlpPoorWire(const TrackSegment& ts, int netIdx) const;
-    vector<HistUsageT> getShortWireSegmentUsageOnOvlpHistWire(const TrackSegment& ts, int netIdx) const;
-    // handle: (interval, usage)
-    void iterateWireSegments(const TrackSegment& ts,
-                             int netIdx,
-                             const std::function<void(const utils::IntervalT<int>&, int)>& handle) const;
-    void iteratePoorWireSegments(const TrackSegment& ts,
-                                 int netIdx,
-                                 const std::function<void(const utils::IntervalT<int>&)>& handle) const;
-    void iterateHistWireSegments(const TrackSegment& ts,
-                                 int netIdx,
-                                 const std::function<void(const utils::IntervalT<int>&, HistUsageT)>& handle) const;
+    void getShortWireSegmentUsageOnOvlpWire(const TrackSegment& ts, int netIdx, vector<int>& crossPointUsage) const;
+    void getShortWireSegmentUsageOnOvlpPoorWire(const TrackSegment& ts,
+                                                int netIdx,
+                                                vector<int>& crossPointUsage) const;
+    void getShortWireSegmentUsageOnOvlpHistWire(const TrackSegment& ts,
+                                                int netIdx,
+                                                vector<HistUsageT>& crossPointUsage) const;
+    // (usage x dist) of wires, poor wires and hist wires by the prefix sums of the track (setting.dbUseTrackCostCache),
+    // false if disabled or the net itself has segments on the track (then the maps should be iterated)
+    bool getCachedWireSegmentUsage(const TrackSegment& ts,
+                                   int netIdx,
+                                   bool histCost,
+                                   int64_t& wireUsage,
+                                   int64_t& poorWireUsage,
+                                   double& histWireUsage) const;
+    // handle: (interval, usage), templated so that the per-interval work can be inlined
+    // With read locks, the segments are copied out and the handle runs after unlocking, as it may query another
+    // track, whose stripe can be the held one (spin locks are not recursive).
+    template <typename HandleT>
+    void iterateWireSegments(const TrackSegment& ts, int netIdx, const HandleT& handle) const {
+        const auto& cps = ts.crossPointRange;
+        auto lock = readLock(TrackLockKind::WIRE, ts.layerIdx, ts.trackIdx);
+        auto segments = routedWireMap[ts.layerIdx][ts.trackIdx].equal_range(cps.low, cps.high);
+        boost::container::small_vector<std::pair<utils::IntervalT<int>, int>, 8> lockedSegments;
+        for (auto it = segments.first; it != segments.second; ++it) {
+            int usage = it->numNets();
+            if (it->hasNet(netIdx)) {
+                --usage;
+            }
+            if (usage > 0) {
+                utils::IntervalT<int> intvl(max(it->low, cps.low), min(it->high, cps.high));
+                if (lock.owns_lock()) {
+                    lockedSegments.emplace_back(intvl, usage);
+                } else {
+                    handle(intvl, usage);
+                }
+            }
+        }
+        if (lock.owns_lock()) {
+            lock.unlock();
+            for (const auto& segment : lockedSegments) handle(segment.first, segment.second);
+        }
+    }
+    // handle: (interval)
+    template <typename HandleT>
+    void iteratePoorWireSegments(const TrackSegment& ts, int netIdx, const HandleT& handle) const {
+        auto queryInterval = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
+        auto intervals = poorWireMap[ts.layerIdx][ts.trackIdx].equal_range(queryInterval);
+        for (auto it = intervals.first; it != intervals.second; ++it) {
+            auto mergedInterval = it->first & queryInterval;
+            if (netIdx != it->second.netIdx) {
+                handle(utils::IntervalT<int>(first(mergedInterval), last(mergedInterval)));
+            }
+        }
+    }
+    // handle: (interval, discounted usage)
+    template <typename HandleT>
+    void iterateHistWireSegments(const TrackSegment& ts, int netIdx, const HandleT& handle) const {
+        auto queryInterval = boost::icl::interval<int>::closed(ts.crossPointRange.low, ts.crossPointRange.high);
+        auto intervals = histWireMap[ts.layerIdx][ts.trackIdx].equal_range(queryInterval);
+        for (auto it = intervals.first; it != intervals.second; ++it) {
+            auto mergedInterval = it->first & queryInterval;
+            if (netIdx != it->second.netIdx) {
+                handle(utils::IntervalT<int>(first(mergedInterval), last(mergedInterval)),
+                       getHistWireUsage(it->second));
+            }
+        }
+    }
     // return crossPoint indexes
-    vector<int> getWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx) const;
-    vector<int> getShortWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx) const;
+    vector<int> getWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx) const {
+        vector<int> vioCPs;
+        getWireSegmentSpaceVioOnWires(ts, netIdx, vioCPs);
+        return vioCPs;
+    }
+    void getWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx, vector<int>& vioCPs) const;
+    void getShortWireSegmentSpaceVioOnWires(const TrackSegment& ts, int netIdx, vector<int>& vioCPs) const;
     // 2.2 wire on vias
     // return crossPoint indexes (may be out of the range of TrackSegment)
-    vector<int> getWireSegmentUsageOnVias(const TrackSegment& ts, int netIdx) const;
+    vector<int> getWireSegmentUsageOnVias(const TrackSegment& ts, int netIdx) const {
+        vector<int> viaCPs;
+        getWireSegmentUsageOnVias(ts, netIdx, viaCPs);
+        return viaCPs;
+    }
+    void getWireSegmentUsageOnVias(const TrackSegment& ts, int netIdx, vector<int>& viaCPs) const;
     void getWireSegmentUsageOnVias(const TrackSegment& ts,
                                    int netIdx,
-                                   const vector<vector<vector<bool>>>& wireVia,
+                                   const BitLUTs& wireVia,
                                    const ViaMapT& routedViaMap,
                                    bool wireBotVia,
                                    vector<int>& viaCPs) const;
@@ -164,7 +259,8 @@ public:
     void useEdge(const GridEdge& edge, int netIdx);
     void useVia(const GridPoint& via, int netIdx, ViaMapT& routedViaMap);
     void useVia(const GridPoint& via, int netIdx);
-    void markViaType(const GridPoint& via, const ViaType* viaType);
+    void useVias(vector<GridPoint>& vias, int netIdx);  // in bulk, vias will be sorted
+    void markViaType(const GridPoint& via, int netIdx, const ViaType* viaType);
     void useWireSegment(const TrackSegment& ts, int netIdx);
     void useWrongWayWireSegment(const WrongWaySegment& wws, int netIdx);
     void usePoorWireSegment(const TrackSegment& ts, int netIdx);
@@ -176,6 +272,7 @@ public:
     void removeEdge(const GridEdge& edge, int netIdx);
     void removeVia(const GridPoint& via, int netIdx, ViaMapT& routedViaMap);
     void removeVia(const GridPoint& via, int netIdx);
+    void removeVias(vector<GridPoint>& vias, int netIdx);  // in bulk, vias will be sorted
     void removeWireSegment(const TrackSegment& ts, int netIdx);
     void removeWrongWayWireSegment(const WrongWaySegment& wws, int netIdx);
 
@@ -230,31 +327,76 @@ protected:
     // Wire segments
     // 1. routed wires
     // (layerIdx, trackIdx) -> all (crossPointRange, netIdxs)
-    // TODO: change set to unordered_set or vector or list
-    vector<vector<boost::icl::interval_map<int, std::set<int>>>> routedWireMap;
-    vector<vector<mutex_wrapper>> wireLocks;
+    vector<vector<WireMap>> routedWireMap;
     // 2. poor wires due to violations with pin/obs
     // (layerIdx, trackIdx) -> all (crossPointRange, netIdx)
     vector<vector<boost::icl::interval_map<int, PoorWire>>> poorWireMap;
     // 3. wires with history violations
     // (layerIdx, trackIdx) -> all (crossPointRange, discountedUsage)
+    // fadeHistCost only bumps histFadeEpoch, and the nets excepted by it record the epoch in histWireFadeSkips
     vector<vector<boost::icl::interval_map<int, HistWire>>> histWireMap;
     vector<vector<boost::icl::interval_map<int, HistWire>>> histWireMap_copy;
+    int histFadeEpoch = 0, histFadeEpoch_copy = 0;
+    vector<vector<int>> histWireFadeSkips, histWireFadeSkips_copy;  // netIdx -> sorted epochs of fades skipping it
+    HistUsageT getHistWireUsage(const HistWire& histWire) const;
+    void fadeOverlappedHistWires(int layerIdx, int trackIdx, const boost::icl::interval<int>::type& iclRange);
+    // 4. cost caches (allocated when a track is queried), whose stamp is (trackCostEpoch, trackVersions)
+    // trackVersions is bumped on changes of routed wires (under the write lock of the track), and trackCostEpoch is
+    // bumped on changes of poor/hist wires (in single-threaded phases)
+    mutable vector<vector<TrackCostCacheSlot>> trackCostCaches;
+    vector<vector<uint32_t>> trackVersions;
+    uint32_t trackCostEpoch = 0;
+    void touchTrack(int layerIdx, int trackIdx) {
+        if (!trackVersions.empty()) ++trackVersions[layerIdx][trackIdx];
+    }
+    uint64_t getTrackCostStamp(int layerIdx, int trackIdx) const {
+        return (uint64_t(trackCostEpoch) << 32) | trackVersions[layerIdx][trackIdx];
+    }
+    void buildTrackCostCache(int layerIdx, int trackIdx, TrackCostCache& cache) const;
 
     // Vias
     // (layerIdx, trackIdx) -> all (crossPointIdx, netIdx)
     // (layerIdx, trackIdx, crossPointIdx) -> all netIdx
     ViaMapT routedViaMap;          // major version, recorded by lower GridPoint
     ViaMapT routedViaMapUpper;     // recorded by upper GridPoint
-    NDViaMapT routedNonDefViaMap;  // TODO: merge into routedViaMap
-    vector<vector<mutex_wrapper>> viaLocks;
-    vector<vector<mutex_wrapper>> viaLocksUpper;
-    std::mutex viaTypeLock;
     vector<vector<vector<std::pair<int, ViaData*>>>> poorViaMap;
     vector<bool> usePoorViaMap;
-    vector<vector<std::unordered_map<int, HistUsageT>>> histViaMap;
-    vector<vector<std::unordered_map<int, HistUsageT>>> histViaMap_copy;
+    // the real hist usage of a via is its usage in histViaMap x histViaScale, so that a fade only updates the scale
+    // once the scale drops below histViaCompactScale (e.g., every other fade by the default rrrFadeCoeff), it is folded
+    // into the usages, and the ones with a real usage below histViaCompactEps are dropped (compaction)
+    vector<vector<HistViaMap>> histViaMap;
+    vector<vector<HistViaMap>> histViaMap_copy;
+    HistUsageT histViaScale = 1.0;
+    HistUsageT histViaScale_copy = 1.0;
+    static constexpr HistUsageT histViaCompactScale = 1e-3;
+    static constexpr HistUsageT histViaCompactEps = 1e-6;
+    void compactHistVias();
     std::array<double, 4> _vio_usage;
+
+    // Locks of tracks
+    // (layerIdx, trackIdx, kind) is hashed to a fixed pool of spin locks (lock striping)
+    // a thread holds at most one of them at a time, so stripes shared by different tracks cannot deadlock, i.e., no
+    // other track may be queried in a critical section (e.g., by a handle or a cache rebuild)
+    enum class TrackLockKind { WIRE = 0, VIA = 1, VIA_UPPER = 2 };
+    using TrackLockT = std::unique_lock<utils::spin_lock>;
+    mutable utils::striped_locks<4096> trackLocks;
+    // Writes are locked whenever more than one thread runs, even in BATCH mode: nets of a batch have disjoint padded
+    // guides, but their wires may still be inserted into (and shift) the same per-track container.
+    bool lockOnWrite = true;  // off when single-threaded (lock elision)
+    bool lockOnRead = false;
+    utils::spin_lock& getTrackLock(TrackLockKind kind, int layerIdx, int trackIdx) const {
+        return trackLocks.get((uint64_t(layerIdx) << 40) | (uint64_t(trackIdx) << 8) | uint64_t(kind));
+    }
+    TrackLockT writeLock(TrackLockKind kind, int layerIdx, int trackIdx) const {
+        return lockOnWrite ? TrackLockT(getTrackLock(kind, layerIdx, trackIdx)) : TrackLockT();
+    }
+    TrackLockT readLock(TrackLockKind kind, int layerIdx, int trackIdx) const {
+        return lockOnRead ? TrackLockT(getTrackLock(kind, layerIdx, trackIdx)) : TrackLockT();
+    }
+    TrackLockT readViaLock(const ViaMapT& viaMap, int layerIdx, int trackIdx) const {
+        auto kind = (&viaMap == &routedViaMapUpper) ? TrackLockKind::VIA_UPPER : TrackLockKind::VIA;
+        return readLock(kind, layerIdx, trackIdx);
+    }
 };
 
 }  //   namespace db
@@ -5,6 +5,13 @@
 namespace db {
 
 BETTER_ENUM(VerboseLevelT, int, LOW = 0, MIDDLE = 1, HIGH = 2);
+// BATCH: barrier-synchronized batches of non-conflicting nets
+// DAG: a net starts once all its conflicting nets of higher priority are done
+// COLORING: by coloring of the conflict graph, either the same batches as BATCH (in parallel by Jones-Plassmann),
+//           or load-balanced batches (see multiNetScheduleMaxBatches)
+BETTER_ENUM(MultiNetScheduleModeT, int, BATCH = 0, DAG = 1, COLORING = 2);
+// priority queue of the maze search (see single_net/MazeQueue.h)
+BETTER_ENUM(MazeQueueT, int, BINARY = 0, DARY = 1, RADIX = 2);
 
 // global setting
 class Setting {
@@ -13,12 +20,20 @@ public:
     std::string outputFile;
     int numThreads = 1;  // 0 for simple scheduling
     int tat = std::numeric_limits<int>::max();
+    bool numaAware = false;  // pin threads to cpus & spread the routing grid over NUMA nodes
 
     // multi_net
     VerboseLevelT multiNetVerbose = VerboseLevelT::MIDDLE;
     bool multiNetScheduleSortAll = true;
     bool multiNetScheduleSort = true;
     bool multiNetScheduleReverse = true;
+    MultiNetScheduleModeT multiNetScheduleMode = MultiNetScheduleModeT::BATCH;  // ignored in simple scheduling
+    // in COLORING mode, balance the loads of at most this many batches (more only if forced by conflicts),
+    // 0 for the first-fit batches of BATCH
+    int multiNetScheduleMaxBatches = 0;
+    bool multiNetFusePipeline = false;     // run all stages of a net in one job instead of one barrier per stage
+    bool multiNetScheduleBalance = false;  // pack batches by predicted runtimes (ignored in DAG mode)
+    int multiNetNumTiles = 0;  // # of tiles along the longer side of die for tile-local nets in iter 0, 0 to disable
     int multiNetSelectViaTypesIter = 3;
     int rrrIterLimit = 4;
     bool rrrWriteEachIter = false;
@@ -33,6 +48,12 @@ public:
     double wrongWayPointDensity = 0.1;
     double wrongWayPenaltyCoeff = 4;  // at least weightWrongWayWirelength / weightWirelength + 1 = 3
     bool fixOpenBySST = true;
+    MazeQueueT singleNetMazeQueue = MazeQueueT::BINARY;
+    bool singleNetMazeQueueBench = false;  // also route each net with every maze queue, and report their runtimes
+    bool singleNetMazeAStar = false;  // guide the maze search by a lower bound of the cost to the unvisited pins
+    // search two-pin nets from both pins (instead of A*/Dijkstra), opt-in as it breaks ties between paths of equal
+    // cost differently, and so changes the routing result
+    bool singleNetMazeBidirectional = false;
 
     // db
     VerboseLevelT dbVerbose = VerboseLevelT::MIDDLE;
@@ -43,6 +64,7 @@ public:
     double dbPoorViaPenaltyCoeff = 8;
     double dbInitHistUsageForPinAccess = 0.1;
     double dbNondefaultViaPenaltyCoeff = 0.005;
+    bool dbUseTrackCostCache = false;  // cost wire segments by per-track prefix sums (rebuilt lazily on changes)
 
     //  Metric weights of ISPD 2018 Contest
     //  Wirelength unit is M2 pitch
@@ -61,29 +61,30 @@ void printWarnMsg(RouteStatus status, const Net& net) {
 }
 
 void StageRouteStat::clear() {
-    allNetStatusCounters.clear();
-    miscEventCounters.clear();
+    allNetStatusCounters.fill(0);
+    miscEventCounters.fill(0);
 }
 
-std::mutex stageRouteStatusMutex;
-std::mutex miscEventMutex;
-
-void StageRouteStat::increment(RouteStatus status) {
-    stageRouteStatusMutex.lock();
-    ++allNetStatusCounters[status._to_integral()];
-    stageRouteStatusMutex.unlock();
+StageRouteStat& StageRouteStat::operator+=(const StageRouteStat& rhs) {
+    for (int i = 0; i < allNetStatusCounters.size(); ++i) {
+        allNetStatusCounters[i] += rhs.allNetStatusCounters[i];
+    }
+    for (int i = 0; i < miscEventCounters.size(); ++i) {
+        miscEventCounters[i] += rhs.miscEventCounters[i];
+    }
+    return *this;
 }
 
-void StageRouteStat::increment(MiscRouteEvent misc, int count) {
-    miscEventMutex.lock();
-    miscEventCounters[misc._to_integral()] += count;
-    miscEventMutex.unlock();
+bool StageRouteStat::empty() const {
+    auto isZero = [](int count) { return count == 0; };
+    return std::all_of(allNetStatusCounters.begin(), allNetStatusCounters.end(), isZero) &&
+           std::all_of(miscEventCounters.begin(), miscEventCounters.end(), isZero);
 }
 
 void StageRouteStat::print(const std::string& stageStr) const {
     // allNetStatusCounters
     int numTotal = 0, numSucc = 0;
-    iterateEnumCountersInOrder<RouteStatus, int>(allNetStatusCounters, [&](RouteStatus status, int count){
+    iterateEnumCountersInOrder<RouteStatus>(allNetStatusCounters, [&](RouteStatus status, int count){
         numTotal += count;
         if (isSucc(status)) {
             numSucc += count;
@@ -93,7 +94,7 @@ void StageRouteStat::print(const std::string& stageStr) const {
     log() << stageStr << ": #nets = " << numTotal << std::endl;
     log() << "\t#succ = " << numSucc << " (";
     int i = 0;
-    iterateEnumCountersInOrder<RouteStatus, int>(allNetStatusCounters, [&](RouteStatus status, int count){
+    iterateEnumCountersInOrder<RouteStatus>(allNetStatusCounters, [&](RouteStatus status, int count){
         if (isSucc(status)) {
             std::cout << "#" << status << " = " << count << " ";
         }
@@ -103,7 +104,7 @@ void StageRouteStat::print(const std::string& stageStr) const {
     if (numFail > 0) {
         log() << "\t#fail = " << numFail << " (";
         i = 0;
-        iterateEnumCountersInOrder<RouteStatus, int>(allNetStatusCounters, [&](RouteStatus status, int count){
+        iterateEnumCountersInOrder<RouteStatus>(allNetStatusCounters, [&](RouteStatus status, int count){
             if (!isSucc(status)) {
                 std::cout << "#" << status << " = " << count << " ";
             }
@@ -113,21 +114,27 @@ void StageRouteStat::print(const std::string& stageStr) const {
     }
 
     // miscEventCounters
-    if (!miscEventCounters.empty()) {
+    if (std::any_of(miscEventCounters.begin(), miscEventCounters.end(), [](int count) { return count != 0; })) {
         log() << "\tmisc (";
-        iterateEnumCountersInOrder<MiscRouteEvent, int>(miscEventCounters, [&](MiscRouteEvent event, int count){
+        iterateEnumCountersInOrder<MiscRouteEvent>(miscEventCounters, [&](MiscRouteEvent event, int count){
             std::cout << "#" << event << " = " << count << " ";
         });
         std::cout << ")" << std::endl;
     }
 }
 
-void RouteStat::clear() { stages.clear(); }
+void RouteStat::clear() { threadStats.assign(std::max(1, setting.numThreads), {}); }
 
 void RouteStat::print() const {
-    iterateEnumCountersInOrder<RouteStage, StageRouteStat>(stages, [](RouteStage stage, StageRouteStat stageStat) {
-        stageStat.print("Stage " + std::string(stage._to_string()));
-    });
+    for (RouteStage stage : RouteStage::_values()) {
+        StageRouteStat stageStat;
+        for (const auto& threadStat : threadStats) {
+            stageStat += threadStat.stages[stage._to_integral()];
+        }
+        if (!stageStat.empty()) {
+            stageStat.print("Stage " + std::string(stage._to_string()));
+        }
+    }
 }
 
 }  // namespace db
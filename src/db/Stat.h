@@ -44,13 +44,16 @@ BETTER_ENUM(MiscRouteEvent,
 
 BETTER_ENUM(RouteStage, int, PRE, MAZE, POST_MAZE, POST, ALL);
 
-template <typename EnumT, typename MappedT>
-void iterateEnumCountersInOrder(const std::unordered_map<int, MappedT>& counters,
-                                const std::function<void(EnumT, MappedT)>& handle) {
+// counters indexed by the integral values of EnumT (consecutive from 0)
+template <typename EnumT>
+using EnumCounters = std::array<int, EnumT::_size_constant>;
+
+template <typename EnumT>
+void iterateEnumCountersInOrder(const EnumCounters<EnumT>& counters, const std::function<void(EnumT, int)>& handle) {
     for (EnumT enumType : EnumT::_values()) {
-        auto it = counters.find(enumType._to_integral());
-        if (it != counters.end()) {
-            handle(EnumT::_from_integral(it->first), it->second);
+        int count = counters[enumType._to_integral()];
+        if (count != 0) {
+            handle(enumType, count);
         }
     }
 }
@@ -71,29 +74,34 @@ void printWarnMsg(RouteStatus status, const Net& net);
 class StageRouteStat {
 public:
     void clear();
-    void increment(RouteStatus status);
-    void increment(MiscRouteEvent misc, int count);
+    void increment(RouteStatus status) { ++allNetStatusCounters[status._to_integral()]; }
+    void increment(MiscRouteEvent misc, int count) { miscEventCounters[misc._to_integral()] += count; }
+    StageRouteStat& operator+=(const StageRouteStat& rhs);
+    bool empty() const;
     void print(const std::string& stageStr) const;
 
 private:
-    std::unordered_map<int, int> allNetStatusCounters;
-    std::unordered_map<int, int> miscEventCounters;
+    EnumCounters<RouteStatus> allNetStatusCounters{};
+    EnumCounters<MiscRouteEvent> miscEventCounters{};
 };
 
+// Each thread of threadPool increments its own counters without locking, which are merged on print
 class RouteStat {
 public:
     template <typename... Args>
     void increment(RouteStage stage, Args... params) {
-        routeStatusMutex.lock();
-        stages[stage._to_integral()].increment(params...);
-        routeStatusMutex.unlock();
+        int threadIdx = std::max(0, utils::thread_pool::thread_idx());
+        assert(threadIdx < threadStats.size());
+        threadStats[threadIdx].stages[stage._to_integral()].increment(params...);
     }
-    void clear();
+    void clear();  // called once threadPool is initialized (to allocate the counters of all threads), and per iter
     void print() const;
 
 private:
-    std::unordered_map<int, StageRouteStat> stages;
-    std::mutex routeStatusMutex;
+    struct alignas(64) ThreadRouteStat {
+        std::array<StageRouteStat, RouteStage::_size_constant> stages;
+    };
+    vector<ThreadRouteStat> threadStats;
 };
 
 extern RouteStat routeStat;
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "global.h"
+
+#include <atomic>
+
+namespace db {
+
+// Prefix sums of "weight x dist cost" over the disjoint and sorted segments of a track
+// The sum over a cross point range takes two binary searches and two lookups (plus clipping the boundary segments).
+template <typename T>
+class SegmentPrefixSums {
+public:
+    vector<int> nets;  // sorted nets owning some segments (the sums include them)
+
+    void clear() {
+        lows.clear();
+        highs.clear();
+        weights.clear();
+        sums.assign(1, 0);
+        nets.clear();
+    }
+    bool empty() const { return lows.empty(); }
+    bool hasNet(int netIdx) const { return std::binary_search(nets.begin(), nets.end(), netIdx); }
+
+    // segments should be pushed in increasing order, accDistCost is MetalLayer::accCrossPointDistCost
+    void push_back(int low, int high, T weight, const vector<DBU>& accDistCost) {
+        lows.push_back(low);
+        highs.push_back(high);
+        weights.push_back(weight);
+        sums.push_back(sums.back() + weight * (accDistCost[high + 1] - accDistCost[low]));
+    }
+    T sum(int low, int high, const vector<DBU>& accDistCost) const {
+        int first = std::partition_point(highs.begin(), highs.end(), [low](int h) { return h < low; }) - highs.begin();
+        int last = std::partition_point(lows.begin(), lows.end(), [high](int l) { return l <= high; }) - lows.begin();
+        if (first >= last) return 0;
+        T result = sums[last] - sums[first];
+        if (lows[first] < low) result -= weights[first] * (accDistCost[low] - accDistCost[lows[first]]);
+        if (highs[last - 1] > high) {
+            result -= weights[last - 1] * (accDistCost[highs[last - 1] + 1] - accDistCost[high + 1]);
+        }
+        return result;
+    }
+
+private:
+    vector<int> lows;
+    vector<int> highs;
+    vector<T> weights;
+    vector<T> sums = {0};
+};
+
+// Cost sums of a track, which are rebuilt lazily when the track has changed (i.e., its stamp is out of date)
+// The stamp is stored (with release) after a rebuild, so a reader seeing an up-to-date stamp may skip the track lock.
+class TrackCostCache {
+public:
+    std::atomic<uint64_t> stamp{~uint64_t(0)};
+    SegmentPrefixSums<int64_t> wire;  // weight: # nets (usage without excluding any net)
+    SegmentPrefixSums<int64_t> poorWire;
+    SegmentPrefixSums<double> histWire;  // weight: hist usage
+};
+
+// A lazily allocated cache, whose pointer is published atomically for lock-free readers
+class TrackCostCacheSlot {
+public:
+    TrackCostCacheSlot() = default;
+    TrackCostCacheSlot(TrackCostCacheSlot&& rhs) noexcept : cache(rhs.cache.exchange(nullptr)) {}  // for resize only
+    TrackCostCacheSlot(const TrackCostCacheSlot&) = delete;
+    TrackCostCacheSlot& operator=(const TrackCostCacheSlot&) = delete;
+    ~TrackCostCacheSlot() { delete cache.load(); }
+
+    TrackCostCache* get() const { return cache.load(std::memory_order_acquire); }
+    // should be called under the track lock
+    TrackCostCache& getOrCreate() {
+        TrackCostCache* ptr = cache.load(std::memory_order_relaxed);
+        if (!ptr) {
+            ptr = new TrackCostCache;
+            cache.store(ptr, std::memory_order_release);
+        }
+        return *ptr;
+    }
+
+private:
+    std::atomic<TrackCostCache*> cache{nullptr};
+};
+
+}  // namespace db
@@ -0,0 +1,81 @@
+#include "ViaMap.h"
+
+namespace db {
+
+namespace {
+bool lessCP(const ViaMap::value_type& lhs, const ViaMap::value_type& rhs) {
+    return lhs.crossPointIdx < rhs.crossPointIdx;
+}
+}  // namespace
+
+ViaMap::const_iterator ViaMap::find(int crossPointIdx, int netIdx) const {
+    value_type via{crossPointIdx, netIdx, nullptr};
+    auto itEnd = std::upper_bound(vias.begin(), vias.end(), via, lessCP);
+    for (auto it = std::lower_bound(vias.begin(), vias.end(), via, lessCP); it != itEnd; ++it) {
+        if (it->netIdx == netIdx) return it;
+    }
+    return vias.end();
+}
+
+void ViaMap::insert(int crossPointIdx, int netIdx) {
+    value_type via{crossPointIdx, netIdx, nullptr};
+    vias.insert(std::upper_bound(vias.begin(), vias.end(), via, lessCP), via);
+}
+
+void ViaMap::erase(int crossPointIdx, int netIdx) {
+    auto it = find(crossPointIdx, netIdx);
+    if (it != vias.end()) vias.erase(it);
+}
+
+void ViaMap::setViaType(int crossPointIdx, int netIdx, const ViaType* viaType) {
+    auto it = find(crossPointIdx, netIdx);
+    if (it != vias.end()) vias[it - vias.begin()].viaType = viaType;
+}
+
+const ViaType* ViaMap::getViaType(int crossPointIdx, int netIdx) const {
+    auto it = find(crossPointIdx, netIdx);
+    return (it != vias.end()) ? it->viaType : nullptr;
+}
+
+void ViaMap::insert(const vector<int>& crossPointIdxs, int netIdx) {
+    if (crossPointIdxs.size() == 1) {
+        insert(crossPointIdxs[0], netIdx);
+        return;
+    }
+    // append & merge (stable, i.e., the old ones go first)
+    int numOld = vias.size();
+    for (int cpIdx : crossPointIdxs) {
+        vias.push_back({cpIdx, netIdx, nullptr});
+    }
+    std::inplace_merge(vias.begin(), vias.begin() + numOld, vias.end(), lessCP);
+}
+
+void ViaMap::erase(const vector<int>& crossPointIdxs, int netIdx) {
+    if (crossPointIdxs.size() == 1) {
+        erase(crossPointIdxs[0], netIdx);
+        return;
+    }
+    // one pass, each cross point removes the first matched via
+    auto cpIt = crossPointIdxs.begin();
+    auto out = vias.begin();
+    for (auto it = vias.begin(); it != vias.end(); ++it) {
+        while (cpIt != crossPointIdxs.end() && *cpIt < it->crossPointIdx) ++cpIt;
+        if (cpIt != crossPointIdxs.end() && *cpIt == it->crossPointIdx && it->netIdx == netIdx) {
+            ++cpIt;
+            continue;
+        }
+        if (out != it) *out = *it;
+        ++out;
+    }
+    vias.erase(out, vias.end());
+}
+
+ViaMap::const_iterator ViaMap::lower_bound(int crossPointIdx) const {
+    return std::lower_bound(vias.begin(), vias.end(), value_type{crossPointIdx, 0, nullptr}, lessCP);
+}
+
+ViaMap::const_iterator ViaMap::upper_bound(int crossPointIdx) const {
+    return std::upper_bound(vias.begin(), vias.end(), value_type{crossPointIdx, 0, nullptr}, lessCP);
+}
+
+}  // namespace db
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "global.h"
+
+namespace db {
+
+class ViaType;
+
+// Routed vias on one track: (crossPointIdx, netIdx, viaType) sorted by crossPointIdx
+// It is a flat replacement of std::multimap<int, int>, i.e., vias at the same cross point are kept in the order of
+// insertion, so that range scans are contiguous memory walks.
+// The via type is kept inline, so that it comes for free in the scans.
+class ViaMap {
+public:
+    struct Via {
+        int crossPointIdx;
+        int netIdx;
+        const ViaType* viaType;  // nullptr for the default via type
+    };
+    using value_type = Via;
+    using const_iterator = vector<value_type>::const_iterator;
+
+    void insert(int crossPointIdx, int netIdx);
+    void erase(int crossPointIdx, int netIdx);  // the first one only
+    void setViaType(int crossPointIdx, int netIdx, const ViaType* viaType);  // the first one only
+    const ViaType* getViaType(int crossPointIdx, int netIdx) const;          // nullptr if not found or default
+    // bulk versions, crossPointIdxs should be sorted
+    void insert(const vector<int>& crossPointIdxs, int netIdx);
+    void erase(const vector<int>& crossPointIdxs, int netIdx);
+
+    const_iterator lower_bound(int crossPointIdx) const;
+    const_iterator upper_bound(int crossPointIdx) const;
+    const_iterator begin() const { return vias.begin(); }
+    const_iterator end() const { return vias.end(); }
+    bool empty() const { return vias.empty(); }
+    int size() const { return vias.size(); }
+
+private:
+    vector<value_type> vias;
+
+    const_iterator find(int crossPointIdx, int netIdx) const;
+};
+
+}  // namespace db
@@ -0,0 +1,94 @@
+#include "WireMap.h"
+
+namespace db {
+
+void WireMap::add(int low, int high, int netIdx) {
+    update(low, high, true, [netIdx](NetsT& nets) {
+        auto it = std::lower_bound(nets.begin(), nets.end(), netIdx);
+        if (it == nets.end() || *it != netIdx) nets.insert(it, netIdx);
+    });
+}
+
+void WireMap::subtract(int low, int high, int netIdx) {
+    update(low, high, false, [netIdx](NetsT& nets) {
+        auto it = std::lower_bound(nets.begin(), nets.end(), netIdx);
+        if (it != nets.end() && *it == netIdx) nets.erase(it);
+    });
+}
+
+std::pair<WireMap::const_iterator, WireMap::const_iterator> WireMap::equal_range(int low, int high) const {
+    auto first = std::partition_point(
+        segments.begin(), segments.end(), [low](const Segment& segment) { return segment.high < low; });
+    auto last = std::partition_point(first, segments.end(), [high](const Segment& segment) {
+        return segment.low <= high;
+    });
+    return {first, last};
+}
+
+template <typename UpdateT>
+void WireMap::update(int low, int high, bool fillGaps, const UpdateT& updateNets) {
+    if (low > high) return;
+
+    // the window includes the segments touching [low, high], which may be joined with the updated ones
+    auto first = std::partition_point(
+        segments.begin(), segments.end(), [low](const Segment& segment) { return segment.high < low - 1; });
+    auto last = std::partition_point(first, segments.end(), [high](const Segment& segment) {
+        return segment.low <= high + 1;
+    });
+    if (first == last && !fillGaps) return;
+
+    vector<Segment> pieces;
+    pieces.reserve((last - first) * 2 + 3);
+    auto emit = [&](int pieceLow, int pieceHigh, NetsT&& nets) {
+        if (pieceLow > pieceHigh || nets.empty()) return;
+        if (!pieces.empty() && pieces.back().high + 1 == pieceLow && pieces.back().nets == nets) {
+            pieces.back().high = pieceHigh;
+        } else {
+            pieces.emplace_back();
+            auto& piece = pieces.back();
+            piece.low = pieceLow;
+            piece.high = pieceHigh;
+            piece.nets = std::move(nets);
+        }
+    };
+    auto emitGap = [&](int gapLow, int gapHigh) {
+        if (!fillGaps || gapLow > gapHigh) return;
+        NetsT nets;
+        updateNets(nets);
+        emit(gapLow, gapHigh, std::move(nets));
+    };
+
+    int cur = low;  // first cross point in [low, high] that is not emitted yet
+    for (auto it = first; it != last; ++it) {
+        if (it->low < low) {
+            emit(it->low, std::min(it->high, low - 1), NetsT(it->nets));
+        }
+        int ovlpLow = std::max(it->low, low), ovlpHigh = std::min(it->high, high);
+        if (ovlpLow <= ovlpHigh) {
+            emitGap(cur, ovlpLow - 1);
+            NetsT nets(it->nets);
+            updateNets(nets);
+            emit(ovlpLow, ovlpHigh, std::move(nets));
+            cur = ovlpHigh + 1;
+        }
+        if (it->high > high) {
+            emitGap(cur, high);
+            cur = high + 1;
+            emit(std::max(it->low, high + 1), it->high, NetsT(it->nets));
+        }
+    }
+    emitGap(cur, high);
+
+    // replace the window by the pieces
+    auto firstIdx = first - segments.begin();
+    auto numOld = last - first;
+    auto numNew = static_cast<decltype(numOld)>(pieces.size());
+    if (numNew > numOld) {
+        segments.insert(last, numNew - numOld, Segment());
+    } else if (numNew < numOld) {
+        segments.erase(first + numNew, last);
+    }
+    std::move(pieces.begin(), pieces.end(), segments.begin() + firstIdx);
+}
+
+}  // namespace db
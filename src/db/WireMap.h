@@ -0,0 +1,45 @@
+#pragma once
+
+#include "global.h"
+
+#include <boost/container/small_vector.hpp>
+
+namespace db {
+
+// Routed wires on one track: cross point -> set of nets
+// It is a flat replacement of boost::icl::interval_map<int, std::set<int>> with the same (joining) semantics,
+// i.e., segments are disjoint, sorted, non-empty, and adjacent segments never have the same set of nets.
+class WireMap {
+public:
+    using NetsT = boost::container::small_vector<int, 2>;  // sorted net indices
+
+    struct Segment {
+        int low;
+        int high;  // closed cross point range
+        NetsT nets;
+
+        bool hasNet(int netIdx) const { return std::binary_search(nets.begin(), nets.end(), netIdx); }
+        int numNets() const { return nets.size(); }
+    };
+
+    using const_iterator = vector<Segment>::const_iterator;
+
+    void add(int low, int high, int netIdx);
+    void subtract(int low, int high, int netIdx);
+
+    // segments intersecting [low, high]
+    std::pair<const_iterator, const_iterator> equal_range(int low, int high) const;
+    const_iterator begin() const { return segments.begin(); }
+    const_iterator end() const { return segments.end(); }
+    bool empty() const { return segments.empty(); }
+    int size() const { return segments.size(); }
+
+private:
+    vector<Segment> segments;
+
+    // rewrite the sets of nets on [low, high], gaps are filled only if "fillGaps"
+    template <typename UpdateT>
+    void update(int low, int high, bool fillGaps, const UpdateT& updateNets);
+};
+
+}  // namespace db
@@ -28,6 +28,9 @@ void runISPD18Flow(const boost::program_options::variables_map& vm) {
     db::setting.tat = vm.at("tat").as<int>();
     db::setting.outputFile = vm.at("output").as<std::string>();
     // optional
+    if (vm.count("numaAware")) {
+        db::setting.numaAware = vm.at("numaAware").as<bool>();
+    }
     // multi_net
     if (vm.count("multiNetVerbose")) {
         db::setting.multiNetVerbose =
@@ -42,6 +45,22 @@ void runISPD18Flow(const boost::program_options::variables_map& vm) {
     if (vm.count("multiNetScheduleSort")) {
         db::setting.multiNetScheduleSort = vm.at("multiNetScheduleSort").as<bool>();
     }
+    if (vm.count("multiNetScheduleMode")) {
+        db::setting.multiNetScheduleMode =
+            db::MultiNetScheduleModeT::_from_string(vm.at("multiNetScheduleMode").as<std::string>().c_str());
+    }
+    if (vm.count("multiNetScheduleMaxBatches")) {
+        db::setting.multiNetScheduleMaxBatches = vm.at("multiNetScheduleMaxBatches").as<int>();
+    }
+    if (vm.count("multiNetScheduleBalance")) {
+        db::setting.multiNetScheduleBalance = vm.at("multiNetScheduleBalance").as<bool>();
+    }
+    if (vm.count("multiNetNumTiles")) {
+        db::setting.multiNetNumTiles = vm.at("multiNetNumTiles").as<int>();
+    }
+    if (vm.count("multiNetFusePipeline")) {
+        db::setting.multiNetFusePipeline = vm.at("multiNetFusePipeline").as<bool>();
+    }
     if (vm.count("rrrIters")) {
         db::setting.rrrIterLimit = vm.at("rrrIters").as<int>();
     }
@@ -70,6 +89,19 @@ void runISPD18Flow(const boost::program_options::variables_map& vm) {
     if (vm.count("fixOpenBySST")) {
         db::setting.fixOpenBySST = vm.at("fixOpenBySST").as<bool>();
     }
+    if (vm.count("singleNetMazeQueue")) {
+        db::setting.singleNetMazeQueue =
+            db::MazeQueueT::_from_string(vm.at("singleNetMazeQueue").as<std::string>().c_str());
+    }
+    if (vm.count("singleNetMazeQueueBench")) {
+        db::setting.singleNetMazeQueueBench = vm.at("singleNetMazeQueueBench").as<bool>();
+    }
+    if (vm.count("singleNetMazeAStar")) {
+        db::setting.singleNetMazeAStar = vm.at("singleNetMazeAStar").as<bool>();
+    }
+    if (vm.count("singleNetMazeBidirectional")) {
+        db::setting.singleNetMazeBidirectional = vm.at("singleNetMazeBidirectional").as<bool>();
+    }
     // db
     if (vm.count("dbVerbose")) {
         db::setting.dbVerbose = db::VerboseLevelT::_from_string(vm.at("dbVerbose").as<std::string>().c_str());
@@ -89,6 +121,9 @@ void runISPD18Flow(const boost::program_options::variables_map& vm) {
     if (vm.count("dbInitHistUsageForPinAccess")) {
         db::setting.dbInitHistUsageForPinAccess = vm.at("dbInitHistUsageForPinAccess").as<double>();
     }
+    if (vm.count("dbUseTrackCostCache")) {
+        db::setting.dbUseTrackCostCache = vm.at("dbUseTrackCostCache").as<bool>();
+    }
 
     // Read benchmarks
     Rsyn::ISPD2018Reader reader;
@@ -111,6 +146,12 @@ void runISPD18Flow(const boost::program_options::variables_map& vm) {
     }
 
     // Route
+    threadPool.init(db::setting.numThreads);
+    db::routeStat.clear();
+    if (db::setting.numaAware) {
+        log() << "NUMA: " << utils::numa::num_nodes() << " nodes with cpus " << utils::numa::nodes() << std::endl;
+        threadPool.run_on_all([](int threadIdx) { utils::numa::pin_thread(threadIdx, threadPool.size()); });
+    }
     database.init();
     db::setting.adapt();
     Router router;
@@ -121,6 +162,9 @@ void runISPD18Flow(const boost::program_options::variables_map& vm) {
     log() << "Finish writing def" << std::endl;
     log() << "MEM: cur=" << utils::mem_use::get_current() << "MB, peak=" << utils::mem_use::get_peak() << "MB"
           << std::endl;
+    if (db::setting.numaAware) {
+        log() << "MEM per NUMA node (MB): " << utils::numa::mem_use_per_node() << std::endl;
+    }
     log() << std::endl;
 }
 
@@ -156,10 +200,16 @@ int main(int argc, char* argv[]) {
                 ("tat", value<int>()->required(), "Runtime limit (sec)")
                 ("output", value<std::string>()->required(), "Output file name")
                 // optional
+                ("numaAware", value<bool>())
                 ("multiNetVerbose", value<std::string>())
                 ("multiNetScheduleSortAll", value<bool>())
                 ("multiNetScheduleReverse", value<bool>())
                 ("multiNetScheduleSort", value<bool>())
+                ("multiNetScheduleMode", value<std::string>())
+                ("multiNetScheduleMaxBatches", value<int>())
+                ("multiNetFusePipeline", value<bool>())
+                ("multiNetScheduleBalance", value<bool>())
+                ("multiNetNumTiles", value<int>())
                 ("rrrIters", value<int>())
                 ("rrrWriteEachIter", value<bool>())
                 ("rrrInitVioCostDiscount", value<double>())
@@ -169,12 +219,17 @@ int main(int argc, char* argv[]) {
                 ("wrongWayPointDensity", value<double>())
                 ("wrongWayPenaltyCoeff", value<double>())
                 ("fixOpenBySST", value<bool>())
+                ("singleNetMazeQueue", value<std::string>())
+                ("singleNetMazeQueueBench", value<bool>())
+                ("singleNetMazeAStar", value<bool>())
+                ("singleNetMazeBidirectional", value<bool>())
                 ("dbVerbose", value<std::string>())
                 ("dbUsePoorViaMapThres", value<int>())
                 ("dbPoorWirePenaltyCoeff", value<double>())
                 ("dbPoorViaPenaltyCoeff", value<double>())
                 ("dbNondefaultViaPenaltyCoeff", value<double>())
                 ("dbInitHistUsageForPinAccess", value<double>())
+                ("dbUseTrackCostCache", value<bool>())
                 ;
         // clang-format on
         variables_map vm;
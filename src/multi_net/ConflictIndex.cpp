@@ -0,0 +1,91 @@
+#include "ConflictIndex.h"
+
+void ConflictIndex::init(vector<vector<db::BoxOnLayer>>&& jobBoxes) {
+    boxes = move(jobBoxes);
+
+    // bins are about twice the average box size, with a limited # of bins per layer
+    region = database.dieRegion;
+    double sumWidth = 0, sumHeight = 0;
+    long numBoxes = 0;
+    for (const auto& jobBox : boxes) {
+        for (const auto& box : jobBox) {
+            region = region.UnionWith(box);
+            sumWidth += box.width();
+            sumHeight += box.height();
+            ++numBoxes;
+        }
+    }
+    const int maxNumBins = 256;  // in each direction
+    binWidth = max<DBU>({1, numBoxes ? DBU(2 * sumWidth / numBoxes) : 0, region.width() / maxNumBins + 1});
+    binHeight = max<DBU>({1, numBoxes ? DBU(2 * sumHeight / numBoxes) : 0, region.height() / maxNumBins + 1});
+    numBinsX = region.width() / binWidth + 1;
+    numBinsY = region.height() / binHeight + 1;
+
+    bins.assign(database.getLayerNum(), {});
+    for (auto& layerBins : bins) {
+        layerBins.resize(numBinsX * numBinsY);
+    }
+    touchedBins.clear();
+}
+
+utils::IntervalT<int> ConflictIndex::getBinRange(const utils::IntervalT<DBU>& range,
+                                                 DBU low,
+                                                 DBU binSize,
+                                                 int numBins) const {
+    return {max(0, int((range.low - low) / binSize)), min(numBins - 1, int((range.high - low) / binSize))};
+}
+
+void ConflictIndex::clear() {
+    for (const auto& bin : touchedBins) {
+        bins[bin.first][bin.second].clear();
+    }
+    touchedBins.clear();
+}
+
+void ConflictIndex::insert(int jobIdx) {
+    for (const auto& box : boxes[jobIdx]) {
+        auto xRange = getBinRange(box.x, region.x.low, binWidth, numBinsX);
+        auto yRange = getBinRange(box.y, region.y.low, binHeight, numBinsY);
+        for (int x = xRange.low; x <= xRange.high; ++x) {
+            for (int y = yRange.low; y <= yRange.high; ++y) {
+                auto& bin = bins[box.layerIdx][x * numBinsY + y];
+                if (bin.empty()) {
+                    touchedBins.emplace_back(box.layerIdx, x * numBinsY + y);
+                }
+                bin.push_back({box, jobIdx});
+            }
+        }
+    }
+}
+
+template <typename Visit>
+bool ConflictIndex::visitOverlaps(int jobIdx, const Visit& visit) const {
+    for (const auto& box : boxes[jobIdx]) {
+        auto xRange = getBinRange(box.x, region.x.low, binWidth, numBinsX);
+        auto yRange = getBinRange(box.y, region.y.low, binHeight, numBinsY);
+        for (int x = xRange.low; x <= xRange.high; ++x) {
+            for (int y = yRange.low; y <= yRange.high; ++y) {
+                for (const auto& entry : bins[box.layerIdx][x * numBinsY + y]) {
+                    if (entry.jobIdx != jobIdx && entry.box.HasIntersectWith(box) && visit(entry.jobIdx)) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool ConflictIndex::hasConflict(int jobIdx) const {
+    return visitOverlaps(jobIdx, [](int) { return true; });
+}
+
+void ConflictIndex::getConflicts(int jobIdx, vector<int>& conflicts) const {
+    conflicts.clear();
+    visitOverlaps(jobIdx, [&](int otherIdx) {
+        conflicts.push_back(otherIdx);
+        return false;
+    });
+    std::sort(conflicts.begin(), conflicts.end());
+    conflicts.erase(std::unique(conflicts.begin(), conflicts.end()), conflicts.end());
+}
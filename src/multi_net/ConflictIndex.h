@@ -0,0 +1,36 @@
+#pragma once
+
+#include "db/Database.h"
+
+// Conflict detection among jobs (nets), each of which is a set of (padded) boxes on layers.
+// Boxes are put into uniform-grid bins of each layer, so that a query only visits a few bins and exits on the first
+// hit. Clearing only resets the touched bins, so an index can be reused by every batch.
+class ConflictIndex {
+public:
+    // jobBoxes[jobIdx] are the boxes of a job (should be padded by the caller)
+    void init(vector<vector<db::BoxOnLayer>>&& jobBoxes);
+    const vector<db::BoxOnLayer>& getBoxes(int jobIdx) const { return boxes[jobIdx]; }
+
+    void clear();
+    void insert(int jobIdx);
+    bool hasConflict(int jobIdx) const;
+    // conflicting jobs in the index (sorted, each once), thread-safe if no concurrent insert
+    void getConflicts(int jobIdx, vector<int>& conflicts) const;
+
+private:
+    struct Entry {
+        utils::BoxT<DBU> box;
+        int jobIdx;
+    };
+
+    vector<vector<db::BoxOnLayer>> boxes;
+    utils::BoxT<DBU> region;
+    DBU binWidth, binHeight;
+    int numBinsX, numBinsY;
+    vector<vector<vector<Entry>>> bins;  // (layerIdx, binIdx) -> entries
+    vector<std::pair<int, int>> touchedBins;
+
+    utils::IntervalT<int> getBinRange(const utils::IntervalT<DBU>& range, DBU low, DBU binSize, int numBins) const;
+    template <typename Visit>
+    bool visitOverlaps(int jobIdx, const Visit& visit) const;  // stop once visit returns true
+};
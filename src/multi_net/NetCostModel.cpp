@@ -0,0 +1,115 @@
+#include "NetCostModel.h"
+
+void NetCostModel::init(int numNets) {
+    netFeatures.assign(numNets, {});
+    netRuntimes.assign(numNets, -1);
+}
+
+std::array<double, NetCostModel::numFeatures> NetCostModel::getFeatures(const SingleNetRouter& router) const {
+    const double m2Pitch = database.getLayer(1).pitch;
+    double guideArea = 0;
+    for (const auto& guide : router.localNet.routeGuides) {
+        guideArea += (guide.width() / m2Pitch) * (guide.height() / m2Pitch);
+    }
+    return {1.0, double(router.localNet.estimatedNumOfVertices), guideArea, double(router.localNet.numOfPins())};
+}
+
+void NetCostModel::record(const SingleNetRouter& router, double runtime) {
+    netFeatures[router.dbNet.idx] = getFeatures(router);
+    netRuntimes[router.dbNet.idx] = runtime;
+}
+
+void NetCostModel::fit() {
+    // normal equations (X^T X) c = X^T y
+    double xtx[numFeatures][numFeatures] = {}, xty[numFeatures] = {};
+    int numSamples = 0;
+    double sumRuntime = 0, sumNumVertices = 0;
+    minRuntime = std::numeric_limits<double>::max();
+    for (int i = 0; i < netRuntimes.size(); ++i) {
+        if (netRuntimes[i] < 0) continue;
+        const auto& x = netFeatures[i];
+        for (int r = 0; r < numFeatures; ++r) {
+            for (int c = 0; c < numFeatures; ++c) xtx[r][c] += x[r] * x[c];
+            xty[r] += x[r] * netRuntimes[i];
+        }
+        minRuntime = min(minRuntime, netRuntimes[i]);
+        sumRuntime += netRuntimes[i];
+        sumNumVertices += x[1];
+        ++numSamples;
+    }
+    if (numSamples == 0 || sumRuntime <= 0 || sumNumVertices <= 0) return;
+    calibrated = true;
+    secPerVertex = sumRuntime / sumNumVertices;
+    if (numSamples < numFeatures) return;
+    // slight ridge to keep it solvable (e.g., all nets have the same # of pins)
+    for (int r = 0; r < numFeatures; ++r) xtx[r][r] += 1e-9 * xtx[r][r] + 1e-12;
+    // Gaussian elimination with partial pivoting
+    for (int col = 0; col < numFeatures; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < numFeatures; ++r) {
+            if (abs(xtx[r][col]) > abs(xtx[pivot][col])) pivot = r;
+        }
+        std::swap(xtx[col], xtx[pivot]);
+        std::swap(xty[col], xty[pivot]);
+        for (int r = col + 1; r < numFeatures; ++r) {
+            double ratio = xtx[r][col] / xtx[col][col];
+            for (int c = col; c < numFeatures; ++c) xtx[r][c] -= ratio * xtx[col][c];
+            xty[r] -= ratio * xty[col];
+        }
+    }
+    for (int r = numFeatures - 1; r >= 0; --r) {
+        double sum = xty[r];
+        for (int c = r + 1; c < numFeatures; ++c) sum -= xtx[r][c] * coeffs[c];
+        coeffs[r] = sum / xtx[r][r];
+    }
+    fitted = true;
+}
+
+double NetCostModel::predict(const SingleNetRouter& router) const {
+    const auto features = getFeatures(router);
+    if (!calibrated) {
+        // before any measurement is fitted, only the relative cost matters
+        return features[1];
+    }
+    const double runtime = netRuntimes[router.dbNet.idx];
+    if (runtime >= 0) {
+        // measured before, scaled by the change of guides (e.g., more expansion)
+        const double lastNumVertices = netFeatures[router.dbNet.idx][1];
+        return lastNumVertices > 0 ? runtime * features[1] / lastNumVertices : runtime;
+    }
+    if (!fitted) {
+        return features[1] * secPerVertex;
+    }
+    double cost = 0;
+    for (int i = 0; i < numFeatures; ++i) cost += coeffs[i] * features[i];
+    return max(cost, minRuntime);
+}
+
+void NetCostModel::print() const {
+    if (!calibrated) {
+        printlog("Net cost model: not fitted, use # of vertices");
+        return;
+    }
+    if (!fitted) {
+        printlog("Net cost model: too few samples to fit, runtime =", secPerVertex, "* #vertices");
+        return;
+    }
+    double sumErr = 0, sumRuntime = 0;
+    for (int i = 0; i < netRuntimes.size(); ++i) {
+        if (netRuntimes[i] < 0) continue;
+        double cost = 0;
+        for (int j = 0; j < numFeatures; ++j) cost += coeffs[j] * netFeatures[i][j];
+        sumErr += abs(cost - netRuntimes[i]);
+        sumRuntime += netRuntimes[i];
+    }
+    printlog("Net cost model: runtime =",
+             coeffs[0],
+             "+",
+             coeffs[1],
+             "* #vertices +",
+             coeffs[2],
+             "* guideArea +",
+             coeffs[3],
+             "* #pins, relative abs err =",
+             sumRuntime > 0 ? sumErr / sumRuntime : 0.0);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "single_net/SingleNetRouter.h"
+
+// Predict the maze route runtime (sec) of a net by least squares on
+// (1, # of vertices, guide area in M2 pitch^2, # of pins), fitted by the nets routed in earlier iterations.
+// Nets measured before are predicted by their last runtime scaled by # of vertices.
+// Before the first fit, all nets are predicted by # of vertices (i.e., in one unit).
+class NetCostModel {
+public:
+    static constexpr int numFeatures = 4;
+
+    void init(int numNets);
+    // record the runtime of a routed net (thread-safe for different nets)
+    void record(const SingleNetRouter& router, double runtime);
+    // fit by all recorded nets
+    void fit();
+    double predict(const SingleNetRouter& router) const;
+    void print() const;
+
+private:
+    bool calibrated = false;  // fit() has seen measurements, so predictions are in sec
+    double secPerVertex = 0;
+    bool fitted = false;  // coeffs are solved (with enough measurements)
+    std::array<double, numFeatures> coeffs;
+    double minRuntime = 0;
+    // netIdx -> last measurement
+    vector<std::array<double, numFeatures>> netFeatures;
+    vector<double> netRuntimes;  // negative if not measured
+
+    std::array<double, numFeatures> getFeatures(const SingleNetRouter& router) const;
+};
@@ -1,5 +1,10 @@
 #include "Router.h"
 #include "Scheduler.h"
+#include "single_net/MazeRoute.h"
+
+#include <condition_variable>
+#include <numeric>
+#include <queue>
 
 const MTStat& MTStat::operator+=(const MTStat& rhs) {
     auto dur = rhs.durations;
@@ -28,6 +33,7 @@ ostream& operator<<(ostream& os, const MTStat mtStat) {
 
 void Router::run() {
     allNetStatus.resize(database.nets.size(), db::RouteStatus::FAIL_UNPROCESSED);
+    costModel.init(database.nets.size());
     for (iter = 0; iter < db::setting.rrrIterLimit; iter++) {
         log() << std::endl;
         log() << "################################################################" << std::endl;
@@ -57,6 +63,15 @@ void Router::run() {
             db::rrrIterSetting.print();
         }
         route(netsToRoute);
+        if (db::setting.multiNetScheduleBalance) {
+            costModel.fit();
+            if (db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
+                costModel.print();
+            }
+        }
+        if (db::setting.singleNetMazeQueueBench && db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
+            MazeRoute::printQueueBench();
+        }
         log() << std::endl;
         log() << "Finish RRR iteration " << iter << std::endl;
         log() << "MEM: cur=" << utils::mem_use::get_current() << "MB, peak=" << utils::mem_use::get_peak() << "MB"
@@ -131,11 +146,26 @@ void Router::route(const vector<int>& netsToRoute) {
         printStat();
     }
 
+    Scheduler scheduler(routers);
+    if (iter == 0 && db::setting.multiNetNumTiles > 0 && db::setting.numThreads != 0) {
+        routeTiles(routers, scheduler);
+    }
+
+    if (db::setting.numThreads != 0 && db::setting.multiNetScheduleMode == +db::MultiNetScheduleModeT::DAG) {
+        routeDAG(routers, scheduler);
+        return;
+    }
+
     // schedule
     if (db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
         log() << "Start multi-thread scheduling. There are " << netsToRoute.size() << " nets to route." << std::endl;
     }
-    Scheduler scheduler(routers);
+    const bool balance = db::setting.multiNetScheduleBalance && db::setting.numThreads != 0;
+    if (balance) {
+        vector<double> costs(routers.size());
+        runJobsMT(routers.size(), [&](int routerId) { costs[routerId] = costModel.predict(routers[routerId]); });
+        scheduler.setCosts(move(costs));
+    }
     const vector<vector<int>>& batches = scheduler.schedule();
     if (db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
         log() << "Finish multi-thread scheduling" << ((db::setting.numThreads == 0) ? " using simple mode" : "")
@@ -146,13 +176,33 @@ void Router::route(const vector<int>& netsToRoute) {
     // maze route and commit DB by batch
     int iBatch = 0;
     MTStat allMazeMT, allCommitMT, allGetViaTypesMT, allCommitViaTypesMT;
+    if (db::setting.multiNetFusePipeline) {
+        // commits of a net may overlap queries of others in the same batch
+        database.setLockOnRead(true);
+        for (const vector<int>& batch : batches) {
+            auto fusedMT = runJobsMT(
+                batch.size(), [&](int jobIdx) { routeNet(routers[batch[jobIdx]]); }, balance ? 1 : 0, balance);
+            allMazeMT += fusedMT;
+            if (db::setting.multiNetVerbose >= +db::VerboseLevelT::HIGH && db::setting.numThreads != 0) {
+                int maxNumVertices = 0;
+                for (int i : batch) {
+                    maxNumVertices = std::max(maxNumVertices, routers[i].localNet.estimatedNumOfVertices);
+                }
+                log() << "Batch " << iBatch << " done: size=" << batch.size() << ", fusedMT " << fusedMT
+                      << ", peakM=" << utils::mem_use::get_peak() << ", maxV=" << maxNumVertices << std::endl;
+            }
+            iBatch++;
+        }
+        database.setLockOnRead(false);
+        if (db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
+            printlog("allFusedMT", allMazeMT);
+        }
+        return;
+    }
     for (const vector<int>& batch : batches) {
         // 1 maze route
-        auto mazeMT = runJobsMT(batch.size(), [&](int jobIdx) {
-            auto& router = routers[batch[jobIdx]];
-            router.mazeRoute();
-            allNetStatus[router.dbNet.idx] = router.status;
-        });
+        auto mazeMT = runJobsMT(
+            batch.size(), [&](int jobIdx) { mazeRoute(routers[batch[jobIdx]]); }, balance ? 1 : 0, balance);
         allMazeMT += mazeMT;
         // 2 commit nets to DB
         auto commitMT = runJobsMT(batch.size(), [&](int jobIdx) {
@@ -190,6 +240,109 @@ void Router::route(const vector<int>& netsToRoute) {
     }
 }
 
+void Router::routeTiles(vector<SingleNetRouter>& routers, Scheduler& scheduler) {
+    vector<vector<int>>& tiles = scheduler.scheduleTiles(db::setting.multiNetNumTiles);
+    // large tiles first
+    vector<long> tileSizes(tiles.size(), 0);
+    for (int i = 0; i < tiles.size(); ++i) {
+        for (int routerId : tiles[i]) tileSizes[i] += routers[routerId].localNet.estimatedNumOfVertices;
+    }
+    vector<int> tileIds(tiles.size());
+    std::iota(tileIds.begin(), tileIds.end(), 0);
+    std::stable_sort(tileIds.begin(), tileIds.end(), [&](int lhs, int rhs) { return tileSizes[lhs] > tileSizes[rhs]; });
+    int numNets = 0;
+    for (const auto& tile : tiles) numNets += tile.size();
+
+    // nets of a tile one by one, different tiles in parallel
+    database.setLockOnRead(true);
+    auto tileMT = runJobsMT(tiles.size(),
+                            [&](int jobIdx) {
+                                for (int routerId : tiles[tileIds[jobIdx]]) routeNet(routers[routerId]);
+                            },
+                            1,
+                            true);
+    database.setLockOnRead(false);
+    if (db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
+        log() << "Finish routing " << numNets << " tile-local nets in " << tiles.size() << " tiles" << std::endl;
+        printlog("tileMT", tileMT);
+    }
+}
+
+void Router::routeDAG(vector<SingleNetRouter>& routers, Scheduler& scheduler) {
+    // schedule
+    if (db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
+        log() << "Start multi-thread scheduling using DAG mode." << std::endl;
+    }
+    const NetDAG& dag = scheduler.scheduleDAG();
+    if (db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
+        log() << "Finish multi-thread scheduling using DAG mode. There are " << dag.order.size() << " nets to route, "
+              << dag.numEdges << " edges, and depth " << dag.depth << "." << std::endl;
+        log() << std::endl;
+    }
+
+    // maze route and commit DB once all conflicting nets of higher priority are done
+    vector<int> priorities(routers.size());
+    for (int i = 0; i < dag.order.size(); ++i) {
+        priorities[dag.order[i]] = i;
+    }
+    vector<int> numPreds = dag.numPreds;
+    std::priority_queue<int, vector<int>, std::greater<int>> readyQueue;  // priorities of ready routers
+    for (int routerId : dag.order) {
+        if (numPreds[routerId] == 0) readyQueue.push(priorities[routerId]);
+    }
+    int numDone = 0;
+    std::mutex mtx;
+    std::condition_variable cv;
+
+    database.setLockOnRead(true);
+    MTStat dagMT(max(1, db::setting.numThreads));
+    utils::timer dagTimer;
+    threadPool.run_on_all([&](int threadIdx) {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            cv.wait(lock, [&] { return !readyQueue.empty() || numDone == dag.order.size(); });
+            if (readyQueue.empty()) break;
+            int routerId = dag.order[readyQueue.top()];
+            readyQueue.pop();
+            auto& router = routers[routerId];
+            lock.unlock();
+            routeNet(router);
+            lock.lock();
+            ++numDone;
+            for (int succId : dag.succs[routerId]) {
+                if (--numPreds[succId] == 0) {
+                    readyQueue.push(priorities[succId]);
+                    cv.notify_one();
+                }
+            }
+            if (numDone == dag.order.size()) cv.notify_all();
+        }
+        dagMT.durations[threadIdx] = dagTimer.elapsed();
+    });
+    database.setLockOnRead(false);
+    if (db::setting.multiNetVerbose >= +db::VerboseLevelT::MIDDLE) {
+        printlog("dagMT", dagMT);
+    }
+}
+
+void Router::mazeRoute(SingleNetRouter& router) {
+    utils::timer mazeTimer;
+    router.mazeRoute();
+    if (db::setting.multiNetScheduleBalance) {
+        costModel.record(router, mazeTimer.elapsed());
+    }
+    allNetStatus[router.dbNet.idx] = router.status;
+}
+
+void Router::routeNet(SingleNetRouter& router) {
+    mazeRoute(router);
+    if (!db::isSucc(router.status)) return;
+    router.commitNetToDB();
+    PostRoute postRoute(router.dbNet);
+    postRoute.getViaTypes();
+    UpdateDB::commitViaTypes(router.dbNet);
+}
+
 void Router::finish() {
     PostScheduler postScheduler(database.nets);
     const vector<vector<int>>& batches = postScheduler.schedule();
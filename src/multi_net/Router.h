@@ -2,6 +2,9 @@
 
 #include "db/Database.h"
 #include "single_net/SingleNetRouter.h"
+#include "NetCostModel.h"
+
+class Scheduler;
 
 class Router {
 public:
@@ -11,11 +14,16 @@ private:
     int iter = 0;
     vector<float> _netsCost;
     vector<db::RouteStatus> allNetStatus;
+    NetCostModel costModel;
 
     vector<int> getNetsToRoute();
     void ripup(const vector<int>& netsToRoute);
     void updateCost(const vector<int>& netsToRoute);
     void route(const vector<int>& netsToRoute);
+    void routeTiles(vector<SingleNetRouter>& routers, Scheduler& scheduler);
+    void routeDAG(vector<SingleNetRouter>& routers, Scheduler& scheduler);
+    void mazeRoute(SingleNetRouter& router);
+    void routeNet(SingleNetRouter& router);  // all stages of a net in route()
     void finish();
     void unfinish();
 
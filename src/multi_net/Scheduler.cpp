@@ -1,10 +1,13 @@
 #include "Scheduler.h"
 
-vector<vector<int>> &Scheduler::schedule() {
+#include <atomic>
+
+vector<int> Scheduler::getSortedRouterIds(vector<bool> &assigned) {
     // init assigned table
-    vector<bool> assigned(routers.size(), false);
+    assigned.assign(routers.size(), false);
     for (int i = 0; i < routers.size(); i++) {
-        if (!db::isSucc(routers[i].status) || routers[i].status == +db::RouteStatus::SUCC_ONE_PIN) {
+        if (!db::isSucc(routers[i].status) || routers[i].status == +db::RouteStatus::SUCC_ONE_PIN ||
+            (!inTile.empty() && inTile[i])) {
             assigned[i] = true;
         }
     }
@@ -14,11 +17,19 @@ vector<vector<int>> &Scheduler::schedule() {
     for (int id = 0; id < routers.size(); ++id) {
         routerIds.push_back(id);
     }
-    if (db::setting.multiNetScheduleSortAll) {
+    if (!costs.empty()) {
+        std::stable_sort(routerIds.begin(), routerIds.end(), [&](int lhs, int rhs) { return costs[lhs] > costs[rhs]; });
+    } else if (db::setting.multiNetScheduleSortAll) {
         std::sort(routerIds.begin(), routerIds.end(), [&](int lhs, int rhs) {
             return routers[lhs].localNet.estimatedNumOfVertices > routers[rhs].localNet.estimatedNumOfVertices;
         });
     }
+    return routerIds;
+}
+
+vector<vector<int>> &Scheduler::schedule() {
+    vector<bool> assigned;
+    vector<int> routerIds = getSortedRouterIds(assigned);
 
     if (db::setting.numThreads == 0) {
         // simple case
@@ -27,17 +38,27 @@ vector<vector<int>> &Scheduler::schedule() {
                 batches.push_back({routerId});
             }
         }
+    } else if (db::setting.multiNetScheduleMode == +db::MultiNetScheduleModeT::COLORING) {
+        colorBatches(routerIds, assigned);
     } else {
         // normal case
+        initIndex();
         int lastUnroute = 0;
         while (lastUnroute < routerIds.size()) {
             // create a new batch from a seed
             batches.emplace_back();
             initSet({});
             vector<int> &batch = batches.back();
+            // with costs, the seed (the most costly) bounds the makespan of a batch
+            double batchCost = 0, capacity = std::numeric_limits<double>::max();
             for (int i = lastUnroute; i < routerIds.size(); ++i) {
                 int routerId = routerIds[i];
+                if (!costs.empty() && batchCost + costs[routerId] > capacity) continue;
                 if (!assigned[routerId] && !hasConflict(routerId)) {
+                    if (!costs.empty()) {
+                        if (batch.empty()) capacity = costs[routerId] * db::setting.numThreads;
+                        batchCost += costs[routerId];
+                    }
                     batch.push_back(routerId);
                     assigned[routerId] = true;
                     updateSet(routerId);
@@ -48,14 +69,19 @@ vector<vector<int>> &Scheduler::schedule() {
                 ++lastUnroute;
             }
         }
+    }
 
-        // sort within batches by NumOfVertices
-        if (db::setting.multiNetScheduleSort) {
-            for (auto &batch : batches) {
-                std::sort(batch.begin(), batch.end(), [&](int lhs, int rhs) {
-                    return routers[lhs].localNet.estimatedNumOfVertices > routers[rhs].localNet.estimatedNumOfVertices;
-                });
-            }
+    // sort within batches by costs (longest processing time first) or NumOfVertices
+    if (db::setting.numThreads != 0 && !costs.empty()) {
+        for (auto &batch : batches) {
+            std::stable_sort(
+                batch.begin(), batch.end(), [&](int lhs, int rhs) { return costs[lhs] > costs[rhs]; });
+        }
+    } else if (db::setting.numThreads != 0 && db::setting.multiNetScheduleSort) {
+        for (auto &batch : batches) {
+            std::sort(batch.begin(), batch.end(), [&](int lhs, int rhs) {
+                return routers[lhs].localNet.estimatedNumOfVertices > routers[rhs].localNet.estimatedNumOfVertices;
+            });
         }
     }
 
@@ -66,40 +92,200 @@ vector<vector<int>> &Scheduler::schedule() {
     return batches;
 }
 
-void Scheduler::initSet(vector<int> jobIdxes) {
-    rtrees = RTrees(database.getLayerNum());
-    for (int jobIdx : jobIdxes) {
-        updateSet(jobIdx);
+NetDAG &Scheduler::scheduleDAG() {
+    // keep the priority of BATCH mode, i.e., the first-fit batches (colors) in their routing order (reversed by
+    // default), so that each conflicting pair of nets is routed in the same order as by BATCH
+    vector<bool> assigned;
+    initConflictGraph(getSortedRouterIds(assigned), assigned);
+    vector<int> colors;
+    colorFirstFit(colors);
+    dag.order = toColor;  // by ranks
+    std::stable_sort(dag.order.begin(), dag.order.end(), [&](int lhs, int rhs) {
+        return db::setting.multiNetScheduleReverse ? colors[lhs] > colors[rhs] : colors[lhs] < colors[rhs];
+    });
+
+    // connect each router to the conflicting ones before it (conflicting routers never share a color)
+    dag.numPreds.assign(routers.size(), 0);
+    dag.succs.assign(routers.size(), {});
+    vector<int> depths(routers.size(), 0), positions(routers.size(), -1);
+    for (int i = 0; i < dag.order.size(); ++i) positions[dag.order[i]] = i;
+    for (int routerId : dag.order) {
+        int depth = 0;
+        for (int predId : conflicts[routerId]) {
+            if (positions[predId] > positions[routerId]) continue;
+            dag.succs[predId].push_back(routerId);
+            depth = max(depth, depths[predId]);
+            ++dag.numPreds[routerId];
+        }
+        dag.numEdges += dag.numPreds[routerId];
+        depths[routerId] = depth + 1;
+        dag.depth = max(dag.depth, depths[routerId]);
     }
+
+    return dag;
 }
 
-void Scheduler::updateSet(int jobIdx) {
-    for (const auto &routeGuide : routers[jobIdx].localNet.routeGuides) {
-        DBU safeMargin = database.getLayer(routeGuide.layerIdx).mtSafeMargin / 2;
-        boostBox box(boostPoint(routeGuide.x.low - safeMargin, routeGuide.y.low - safeMargin),
-                     boostPoint(routeGuide.x.high + safeMargin, routeGuide.y.high + safeMargin));
-        rtrees[routeGuide.layerIdx].insert({box, jobIdx});
+void Scheduler::initConflictGraph(const vector<int> &routerIds, const vector<bool> &assigned) {
+    // build the conflict graph in parallel
+    initIndex();
+    initSet({});
+    ranks.assign(routers.size(), -1);
+    toColor.clear();
+    for (int routerId : routerIds) {
+        if (!assigned[routerId]) {
+            ranks[routerId] = toColor.size();
+            toColor.push_back(routerId);
+            updateSet(routerId);
+        }
     }
+    conflicts.assign(routers.size(), {});
+    runJobsMT(toColor.size(), [&](int i) { conflictIndex.getConflicts(toColor[i], conflicts[toColor[i]]); });
 }
 
-bool Scheduler::hasConflict(int jobIdx) {
-    for (const auto &routeGuide : routers[jobIdx].localNet.routeGuides) {
-        DBU safeMargin = database.getLayer(routeGuide.layerIdx).mtSafeMargin / 2;
-        boostBox box(boostPoint(routeGuide.x.low - safeMargin, routeGuide.y.low - safeMargin),
-                     boostPoint(routeGuide.x.high + safeMargin, routeGuide.y.high + safeMargin));
+int Scheduler::colorFirstFit(vector<int> &colors) {
+    // Jones-Plassmann: a router is colored once all its conflicting routers of higher ranks are colored, which gives
+    // the same colors as the sequential first-fit
+    colors.assign(routers.size(), -1);
+    std::unique_ptr<std::atomic<int>[]> numUncolored(new std::atomic<int>[routers.size()]);
+    vector<int> curRound;
+    for (int routerId : toColor) {
+        int num = 0;
+        for (int otherId : conflicts[routerId]) num += (ranks[otherId] < ranks[routerId]);
+        numUncolored[routerId] = num;
+        if (num == 0) curRound.push_back(routerId);
+    }
+    while (!curRound.empty()) {
+        vector<vector<int>> nextRounds(curRound.size());
+        runJobsMT(curRound.size(), [&](int i) {
+            int routerId = curRound[i];
+            vector<bool> used;
+            for (int otherId : conflicts[routerId]) {
+                if (ranks[otherId] > ranks[routerId]) continue;
+                int color = colors[otherId];
+                if (color >= used.size()) used.resize(color + 1, false);
+                used[color] = true;
+            }
+            colors[routerId] = std::find(used.begin(), used.end(), false) - used.begin();
+        });
+        runJobsMT(curRound.size(), [&](int i) {
+            int routerId = curRound[i];
+            for (int otherId : conflicts[routerId]) {
+                if (ranks[otherId] > ranks[routerId] && --numUncolored[otherId] == 0) {
+                    nextRounds[i].push_back(otherId);
+                }
+            }
+        });
+        curRound.clear();
+        for (const auto &nextRound : nextRounds) {
+            curRound.insert(curRound.end(), nextRound.begin(), nextRound.end());
+        }
+    }
+    int numColors = 0;
+    for (int routerId : toColor) numColors = max(numColors, colors[routerId] + 1);
+    return numColors;
+}
 
-        std::vector<std::pair<boostBox, int>> results;
-        rtrees[routeGuide.layerIdx].query(bgi::intersects(box), std::back_inserter(results));
+int Scheduler::colorBalanced(int maxColors, vector<int> &colors) {
+    // sequential, as the loads of colors depend on all routers of higher ranks
+    colors.assign(routers.size(), -1);
+    vector<double> loads(maxColors, 0);
+    vector<int> usedBy(maxColors, -1);  // color -> the last router having a conflicting router of this color
+    for (int routerId : toColor) {
+        for (int otherId : conflicts[routerId]) {
+            if (colors[otherId] >= 0) usedBy[colors[otherId]] = routerId;
+        }
+        int best = -1;
+        for (int color = 0; color < loads.size(); ++color) {
+            if (usedBy[color] != routerId && (best == -1 || loads[color] < loads[best])) best = color;
+        }
+        if (best == -1) {
+            // no admissible color, beyond maxColors
+            best = loads.size();
+            loads.push_back(0);
+            usedBy.push_back(-1);
+        }
+        colors[routerId] = best;
+        loads[best] += costs.empty() ? routers[routerId].localNet.estimatedNumOfVertices : costs[routerId];
+    }
+    return loads.size();
+}
 
-        for (const auto &result : results) {
-            if (result.second != jobIdx) {
-                return true;
-            }
+void Scheduler::colorBatches(const vector<int> &routerIds, const vector<bool> &assigned) {
+    initConflictGraph(routerIds, assigned);
+    vector<int> colors;
+    const int maxBatches = db::setting.multiNetScheduleMaxBatches;
+    int numColors = (maxBatches > 0) ? colorBalanced(maxBatches, colors) : colorFirstFit(colors);
+
+    // each (non-empty) color is a batch, in the order of ranks
+    vector<vector<int>> colorClasses(numColors);
+    for (int routerId : toColor) colorClasses[colors[routerId]].push_back(routerId);
+    for (auto &colorClass : colorClasses) {
+        if (!colorClass.empty()) batches.push_back(move(colorClass));
+    }
+}
+
+vector<vector<int>> &Scheduler::scheduleTiles(int numTiles) {
+    const auto &dieRegion = database.dieRegion;
+    const DBU tileSize = max(dieRegion.width(), dieRegion.height()) / numTiles + 1;
+    const int numTilesX = dieRegion.width() / tileSize + 1;
+    const int numTilesY = dieRegion.height() / tileSize + 1;
+    auto getTileIdx = [&](DBU loc, const utils::IntervalT<DBU> &range) {
+        return (min(max(loc, range.low), range.high) - range.low) / tileSize;
+    };
+
+    initIndex();
+    vector<bool> assigned;
+    vector<int> routerIds = getSortedRouterIds(assigned);
+    if (db::setting.multiNetScheduleReverse) {
+        reverse(routerIds.begin(), routerIds.end());
+    }
+    tiles.assign(numTilesX * numTilesY, {});
+    inTile.assign(routers.size(), false);
+    for (int routerId : routerIds) {
+        const auto &boxes = conflictIndex.getBoxes(routerId);
+        if (assigned[routerId] || boxes.empty()) continue;
+        utils::BoxT<DBU> bbox = boxes[0];
+        for (const auto &box : boxes) bbox = bbox.UnionWith(box);
+        int lx = getTileIdx(bbox.lx(), dieRegion.x), hx = getTileIdx(bbox.hx(), dieRegion.x);
+        int ly = getTileIdx(bbox.ly(), dieRegion.y), hy = getTileIdx(bbox.hy(), dieRegion.y);
+        if (lx == hx && ly == hy) {
+            tiles[lx * numTilesY + ly].push_back(routerId);
+            inTile[routerId] = true;
         }
     }
-    return false;
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(), [](const vector<int> &tile) { return tile.empty(); }),
+                tiles.end());
+    return tiles;
 }
 
+void Scheduler::initIndex() {
+    if (indexed) return;
+    indexed = true;
+    vector<vector<db::BoxOnLayer>> jobBoxes(routers.size());
+    runJobsMT(routers.size(), [&](int jobIdx) {
+        for (const auto &routeGuide : routers[jobIdx].localNet.routeGuides) {
+            DBU safeMargin = database.getLayer(routeGuide.layerIdx).mtSafeMargin / 2;
+            jobBoxes[jobIdx].emplace_back(routeGuide.layerIdx,
+                                          routeGuide.x.low - safeMargin,
+                                          routeGuide.y.low - safeMargin,
+                                          routeGuide.x.high + safeMargin,
+                                          routeGuide.y.high + safeMargin);
+        }
+    });
+    conflictIndex.init(move(jobBoxes));
+}
+
+void Scheduler::initSet(vector<int> jobIdxes) {
+    conflictIndex.clear();
+    for (int jobIdx : jobIdxes) {
+        updateSet(jobIdx);
+    }
+}
+
+void Scheduler::updateSet(int jobIdx) { conflictIndex.insert(jobIdx); }
+
+bool Scheduler::hasConflict(int jobIdx) { return conflictIndex.hasConflict(jobIdx); }
+
 vector<vector<int>> &PostScheduler::schedule() {
     // init assigned table
     vector<bool> assigned(dbNets.size(), false);
@@ -110,6 +296,7 @@ vector<vector<int>> &PostScheduler::schedule() {
         }
     } else {
         // normal case
+        initIndex();
         int lastUnroute = 0;
         while (lastUnroute < dbNets.size()) {
             // create a new batch from a seed
@@ -132,70 +319,56 @@ vector<vector<int>> &PostScheduler::schedule() {
     return batches;
 }
 
+void PostScheduler::initIndex() {
+    vector<vector<db::BoxOnLayer>> jobBoxes(dbNets.size());
+    runJobsMT(dbNets.size(), [&](int jobIdx) { jobBoxes[jobIdx] = getNetBoxes(dbNets[jobIdx]); });
+    conflictIndex.init(move(jobBoxes));
+}
+
 void PostScheduler::initSet(vector<int> jobIdxes) {
-    rtrees = RTrees(database.getLayerNum());
+    conflictIndex.clear();
     for (int jobIdx : jobIdxes) {
         updateSet(jobIdx);
     }
 }
 
-void PostScheduler::updateSet(int jobIdx) {
-    auto &dbNet = dbNets[jobIdx];
-    vector<std::pair<boostBox, int>> boostBoxes = getNetBoxes(dbNet);
-    for (auto &box : boostBoxes) {
-        rtrees[box.second].insert({box.first, jobIdx});
-    }
-}
+void PostScheduler::updateSet(int jobIdx) { conflictIndex.insert(jobIdx); }
 
-// TODO: terminate the postOrderVisitGridTopo when hasCon == true
-bool PostScheduler::hasConflict(int jobIdx) {
-    auto &dbNet = dbNets[jobIdx];
-    bool hasCon = false;
-    std::vector<std::pair<boostBox, int>> results;
-    vector<std::pair<boostBox, int>> boostBoxes = getNetBoxes(dbNet);
-    for (auto &box : boostBoxes) {
-        rtrees[box.second].query(bgi::intersects(box.first), std::back_inserter(results));
-    }
-    for (const auto &result : results) {
-        if (result.second != jobIdx) {
-            hasCon = true;
-            break;
-        }
-    }
-    return hasCon;
-}
+bool PostScheduler::hasConflict(int jobIdx) { return conflictIndex.hasConflict(jobIdx); }
 
-boostBox PostScheduler::getBoostBox(const db::GridPoint &gp) {
+db::BoxOnLayer PostScheduler::getBox(const db::GridPoint &gp) {
     DBU safeMargin = database.getLayer(gp.layerIdx).mtSafeMargin / 2;
     const auto gpLoc = database.getLoc(gp);
-    return {boostPoint(gpLoc.x - safeMargin, gpLoc.y - safeMargin),
-            boostPoint(gpLoc.x + safeMargin, gpLoc.y + safeMargin)};
+    return {gp.layerIdx, gpLoc.x - safeMargin, gpLoc.y - safeMargin, gpLoc.x + safeMargin, gpLoc.y + safeMargin};
 }
 
-boostBox PostScheduler::getBoostBox(const db::GridEdge &edge) {
+db::BoxOnLayer PostScheduler::getBox(const db::GridEdge &edge) {
     DBU safeMargin = database.getLayer(edge.u.layerIdx).mtSafeMargin / 2;
     const auto edgeLoc = database.getLoc(edge);
-    return {boostPoint(edgeLoc.first.x - safeMargin, edgeLoc.first.y - safeMargin),
-            boostPoint(edgeLoc.second.x + safeMargin, edgeLoc.second.y + safeMargin)};
+    return {edge.u.layerIdx,
+            edgeLoc.first.x - safeMargin,
+            edgeLoc.first.y - safeMargin,
+            edgeLoc.second.x + safeMargin,
+            edgeLoc.second.y + safeMargin};
 }
 
-vector<std::pair<boostBox, int>> PostScheduler::getNetBoxes(const db::Net &dbNet) {
-    vector<std::pair<boostBox, int>> boostBoxes;
+vector<db::BoxOnLayer> PostScheduler::getNetBoxes(const db::Net &dbNet) {
+    vector<db::BoxOnLayer> boxes;
     dbNet.postOrderVisitGridTopo([&](std::shared_ptr<db::GridSteiner> node) {
         if (node->parent) {
             db::GridEdge edge(*node, *(node->parent));
             if (edge.isVia()) {
-                boostBoxes.emplace_back(getBoostBox(edge.u), edge.u.layerIdx);
-                boostBoxes.emplace_back(getBoostBox(edge.v), edge.v.layerIdx);
+                boxes.push_back(getBox(edge.u));
+                boxes.push_back(getBox(edge.v));
             } else if (edge.isTrackSegment() || edge.isWrongWaySegment()) {
-                boostBoxes.emplace_back(getBoostBox(edge), node->layerIdx);
+                boxes.push_back(getBox(edge));
             } else {
                 log() << "Warning in " << __func__ << ": invalid edge type. skip." << std::endl;
             }
         }
         if (node->extWireSeg) {
-            boostBoxes.emplace_back(getBoostBox(*(node->extWireSeg)), node->layerIdx);
+            boxes.push_back(getBox(*(node->extWireSeg)));
         }
     });
-    return boostBoxes;
-}
\ No newline at end of file
+    return boxes;
+}
@@ -2,21 +2,59 @@
 
 #include "db/Database.h"
 #include "single_net/SingleNetRouter.h"
+#include "ConflictIndex.h"
+
+// conflict DAG of routers: an edge from u to v if u and v conflict and u has a higher priority
+class NetDAG {
+public:
+    vector<int> order;          // routerIds to route in priority order
+    vector<int> numPreds;       // routerId -> # of conflicting routers with a higher priority
+    vector<vector<int>> succs;  // routerId -> conflicting routers with a lower priority
+    long numEdges = 0;
+    int depth = 0;  // # of routers on the longest path
+};
 
 class Scheduler {
 public:
     Scheduler(const vector<SingleNetRouter>& routersToExec) : routers(routersToExec){};
+    // predicted runtimes of routers for load balancing (i.e., multiNetScheduleBalance)
+    void setCosts(vector<double>&& routerCosts) { costs = move(routerCosts); }
     vector<vector<int>>& schedule();
+    NetDAG& scheduleDAG();
+    // routers whose padded guides are inside a tile (numTiles along the longer side of die), each tile in priority
+    // order; routers of different tiles never conflict, and they are excluded from later schedule()
+    vector<vector<int>>& scheduleTiles(int numTiles);
 
 private:
     const vector<SingleNetRouter>& routers;
+    vector<double> costs;
     vector<vector<int>> batches;
+    NetDAG dag;
+    vector<vector<int>> tiles;
+    vector<bool> inTile;
+
+    // routerIds sorted by sizes, and those need no routing marked as assigned
+    vector<int> getSortedRouterIds(vector<bool>& assigned);
 
     // for conflict detect
-    RTrees rtrees;
+    ConflictIndex conflictIndex;
+    bool indexed = false;
+    void initIndex();
     virtual void initSet(vector<int> jobIdxes);
     virtual void updateSet(int jobIdx);
     virtual bool hasConflict(int jobIdx);
+
+    // conflict graph of the routers to color, ranked in the order of routerIds
+    vector<int> toColor;
+    vector<int> ranks;
+    vector<vector<int>> conflicts;
+    void initConflictGraph(const vector<int>& routerIds, const vector<bool>& assigned);
+    // color routers in the order of ranks by first-fit (in parallel), or by the least-loaded admissible color (with
+    // a new color only if none of the first maxColors ones is admissible); return # of colors
+    int colorFirstFit(vector<int>& colors);
+    int colorBalanced(int maxColors, vector<int>& colors);
+    // each color is a batch
+    void colorBatches(const vector<int>& routerIds, const vector<bool>& assigned);
 };
 
 class PostScheduler {
@@ -29,10 +67,11 @@ private:
     vector<vector<int>> batches;
 
     // for conflict detect
-    RTrees rtrees;
-    boostBox getBoostBox(const db::GridPoint &gp);
-    boostBox getBoostBox(const db::GridEdge &edge);
-    vector<std::pair<boostBox, int>> getNetBoxes(const db::Net& dbNet);
+    ConflictIndex conflictIndex;
+    void initIndex();
+    db::BoxOnLayer getBox(const db::GridPoint &gp);
+    db::BoxOnLayer getBox(const db::GridEdge &edge);
+    vector<db::BoxOnLayer> getNetBoxes(const db::Net& dbNet);
     virtual void initSet(vector<int> jobIdxes);
     virtual void updateSet(int jobIdx);
     virtual bool hasConflict(int jobIdx);   
@@ -3,9 +3,11 @@
 #include <fstream>
 
 void GridGraph::init(int nNodes) {
-    conn.resize(nNodes, {-1, -1, -1, -1, -1, -1});
-    edgeCost.resize(nNodes, {-1, -1, -1, -1, -1, -1});
-    vertexCost.resize(nNodes, 0);
+    vertexToPin.assign(nNodes, -1);
+    fakePins.assign(nNodes, false);
+    vertexCost.assign(nNodes, 0);
+    edgeDirs.assign(nNodes, 0);
+    halfEdges.clear();
 
     edgeCount = 0;
 }
@@ -13,22 +15,39 @@ void GridGraph::init(int nNodes) {
 void GridGraph::addEdge(int u, int v, EdgeDirection dir, db::CostT w) {
     if (hasEdge(u, dir)) return;
 
-    edgeCost[u][dir] = edgeCost[v][getOppDir(dir)] = w;
-    conn[u][dir] = v;
-    conn[v][oppDirections[dir]] = u;
+    halfEdges.push_back({u, v, float(w), dir});
+    halfEdges.push_back({v, u, float(w), getOppDir(dir)});
+    edgeDirs[u] |= 1 << dir;
+    edgeDirs[v] |= 1 << getOppDir(dir);
 
     edgeCount++;
 }
 
-int GridGraph::getPinIdx(int u) const {
-    auto it = vertexToPin.find(u);
-    return (it != vertexToPin.end()) ? it->second : -1;
+void GridGraph::compress() {
+    edgeBegins.resize(edgeDirs.size() + 1);
+    edgeBegins[0] = 0;
+    for (int u = 0; u < edgeDirs.size(); ++u) {
+        edgeBegins[u + 1] = edgeBegins[u] + __builtin_popcount(edgeDirs[u]);
+    }
+    edgeEndPoints.resize(edgeBegins.back());
+    edgeCosts.resize(edgeBegins.back());
+    // a later half edge of the same (u, dir) overwrites the earlier one, as addEdge only checks u
+    for (const auto& edge : halfEdges) {
+        int idx = getEdgeIdx(edge.u, edge.dir);
+        edgeEndPoints[idx] = edge.v;
+        edgeCosts[idx] = edge.cost;
+    }
+    vector<HalfEdge>().swap(halfEdges);
 }
 
 void GridGraph::writeDebugFile(const std::string& fn) const {
     std::ofstream debugFile(fn);
-    for (int i = 0; i < conn.size(); ++i) {
-        debugFile << vertexToGridPoint[i] << " vertexC=" << getVertexCost(i) << " edgeC=" << edgeCost[i] << std::endl;
+    for (int i = 0; i < getNodeNum(); ++i) {
+        std::array<db::CostT, 6> edgeCost;
+        for (auto direction : directions) {
+            edgeCost[direction] = hasEdge(i, direction) ? getEdgeCost(i, direction) : -1;
+        }
+        debugFile << vertexToGridPoint[i] << " vertexC=" << getVertexCost(i) << " edgeC=" << edgeCost << std::endl;
     }
 }
 
@@ -15,23 +15,29 @@ class GridGraphBuilder;
 class GridGraphBuilderBase;
 
 // Note: GridGraph will be across both GridGraphBuilder & MazeRoute
+// Vertex properties are dense arrays, and edges are compressed (CSR) once built:
+// the edges of a vertex are stored consecutively in the order of direction, and edgeDirs[u] has bit dir set if u has
+// an edge of dir, so the edge of a direction is located by counting the lower bits.
 class GridGraph {
 public:
     friend GridGraphBuilder;
     friend GridGraphBuilderBase;
 
     // getters
-    bool hasEdge(int u, EdgeDirection dir) const { return conn[u][dir] != -1; }
-    int getEdgeEndPoint(int u, EdgeDirection dir) const { return conn[u][dir]; }
-    db::CostT getEdgeCost(int u, EdgeDirection dir) const { return edgeCost[u][dir]; }
+    bool hasEdge(int u, EdgeDirection dir) const { return (edgeDirs[u] >> dir) & 1; }
+    uint8_t getEdgeDirs(int u) const { return edgeDirs[u]; }
+    // the edge should exist
+    int getEdgeEndPoint(int u, EdgeDirection dir) const { return edgeEndPoints[getEdgeIdx(u, dir)]; }
+    db::CostT getEdgeCost(int u, EdgeDirection dir) const { return edgeCosts[getEdgeIdx(u, dir)]; }
     db::CostT getVertexCost(int u) const { return vertexCost[u]; }
     bool isMinAreaFixable(int u) const { return minAreaFixable[u]; }
     db::GridPoint& getGridPoint(int u) { return vertexToGridPoint[u]; }
+    const db::GridPoint& getGridPoint(int u) const { return vertexToGridPoint[u]; }
     int getEdgeNum() const { return edgeCount; }
-    int getNodeNum() const { return conn.size(); }
-    int getPinIdx(int u) const;
+    int getNodeNum() const { return edgeDirs.size(); }
+    int getPinIdx(int u) const { return vertexToPin[u]; }
     vector<int>& getVertices(int pinIdx) { return pinToVertex[pinIdx]; }
-    bool isFakePin(int u) const { return fakePins.find(u) != fakePins.end(); }
+    bool isFakePin(int u) const { return fakePins[u]; }
 
     void writeDebugFile(const std::string& fn) const;
 
@@ -39,19 +45,33 @@ private:
     int edgeCount;
 
     // vertex properties
-    std::unordered_map<int, int> vertexToPin;  // vertexIdx to pinIdx
+    vector<int> vertexToPin;  // vertexIdx to pinIdx, -1 for none
     vector<vector<int>> pinToVertex;
-    std::unordered_set<int> fakePins;  // diff-layer access point
+    vector<bool> fakePins;  // diff-layer access point
     vector<db::GridPoint> vertexToGridPoint;
     vector<bool> minAreaFixable;
-
-    // adj lists
-    vector<std::array<int, 6>> conn;
     vector<db::CostT> vertexCost;
-    vector<std::array<db::CostT, 6>> edgeCost;
+
+    // adj lists (CSR)
+    vector<uint8_t> edgeDirs;
+    vector<int> edgeBegins;  // vertexIdx to the idx of its first edge
+    vector<int> edgeEndPoints;
+    vector<float> edgeCosts;
+    int getEdgeIdx(int u, EdgeDirection dir) const {
+        return edgeBegins[u] + __builtin_popcount(edgeDirs[u] & ((1u << dir) - 1));
+    }
+
+    // edges added but not compressed yet
+    struct HalfEdge {
+        int u, v;
+        float cost;
+        EdgeDirection dir;
+    };
+    vector<HalfEdge> halfEdges;
 
     // setters
     void init(int nNodes);
     void setVertexCost(int u, db::CostT w) { vertexCost[u] = w; }
     void addEdge(int u, int v, EdgeDirection dir, db::CostT w);
+    void compress();  // should be called after all the edges are added
 };
@@ -18,6 +18,8 @@ void GridGraphBuilder::run() {
         }
     }
 
+    graph.init(intervals.back().second);
+
     // 2. Add guide-pin connection
     pinToOriVertex.resize(localNet.numOfPins());
     for (unsigned p = 0; p < localNet.numOfPins(); p++) {
@@ -42,8 +44,6 @@ void GridGraphBuilder::run() {
         }
     }
 
-    graph.init(intervals.back().second);
-
     // 3. Add inter-guide connection
     for (unsigned b1 = 0; b1 < localNet.gridRouteGuides.size(); b1++) {
         for (unsigned b2 : localNet.guideConn[b1])
@@ -59,6 +59,7 @@ void GridGraphBuilder::run() {
     setMinAreaFlags();
     addOutofPinPenalty();
     fixDisconnectedPin();
+    graph.compress();
 }
 
 void GridGraphBuilder::addWrongWayConn() {
@@ -228,9 +229,13 @@ void GridGraphBuilder::connectGuide(int guideIdx) {
         return;
     }
 
+    // reused over the tracks
+    vector<utils::IntervalT<int>> directIntervals;
+    vector<utils::IntervalT<int>> indirectIntervals;
+    vector<db::CostT> crossPointCost;
     for (int t = trackRange.low; t <= trackRange.high; t++) {
         // get the directIntervals
-        vector<utils::IntervalT<int>> directIntervals;
+        directIntervals.clear();
         int begin = -1, end = -1;
         for (int c = cpRange.low; c <= cpRange.high; c++) {
             if (begin == -1) {
@@ -246,7 +251,7 @@ void GridGraphBuilder::connectGuide(int guideIdx) {
         }
 
         // get the indirectIntervals
-        vector<utils::IntervalT<int>> indirectIntervals;
+        indirectIntervals.clear();
         if (directIntervals.empty()) {
             indirectIntervals.push_back(cpRange);
         } else {
@@ -263,7 +268,7 @@ void GridGraphBuilder::connectGuide(int guideIdx) {
         for (auto &interval : indirectIntervals) {
             for (int c = interval.low; c + 1 <= interval.high; c++) setEdgeCost(t, c, c + 1);
 
-            const vector<db::CostT> &crossPointCost = database.getShortWireSegmentCost({layerIdx, t, interval}, netIdx);
+            database.getShortWireSegmentCost({layerIdx, t, interval}, netIdx, crossPointCost);
             for (int c = interval.low; c <= interval.high; c++) {
                 int vertex = guideToVertex(guideIdx, t, c);
                 db::CostT cost = crossPointCost[c - interval.low];
@@ -31,12 +31,11 @@ double GridGraphBuilderBase::getPinPointCost(const vector<db::BoxOnLayer> &acces
 
 void GridGraphBuilderBase::updatePinVertex(int pinIdx, int vertexIdx, bool fakePin) {
     if (fakePin) {
-        graph.fakePins.insert(vertexIdx);
+        graph.fakePins[vertexIdx] = true;
     }
     pinToOriVertex[pinIdx].push_back(vertexIdx);
-    auto it = graph.vertexToPin.find(vertexIdx);
-    if (it != graph.vertexToPin.end()) {
-        int oriPinIdx = it->second;
+    int oriPinIdx = graph.vertexToPin[vertexIdx];
+    if (oriPinIdx != -1) {
         if (pinIdx != oriPinIdx) {
             const db::GridPoint& point = vertexToGridPoint[vertexIdx];
             const double oriCost = getPinPointCost(localNet.dbNet.pinAccessBoxes[oriPinIdx], point);
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "db/Database.h"
+
+// Priority queues of the maze search, which pop solutions by (cost, costUB) in increasing order
+// The keys are kept inline, so that the queues do not touch the solution arena.
+struct MazeQueueEntry {
+    db::CostT cost;
+    db::CostT costUB;
+    int sol;  // index in the solution arena
+
+    bool operator<(const MazeQueueEntry &rhs) const {
+        return cost < rhs.cost || (cost == rhs.cost && costUB < rhs.costUB);
+    }
+};
+
+// 1. std::priority_queue (binary heap)
+class BinaryMazeQueue {
+public:
+    void push(const MazeQueueEntry &entry) { queue.push(entry); }
+    MazeQueueEntry pop() {
+        MazeQueueEntry entry = queue.top();
+        queue.pop();
+        return entry;
+    }
+    bool empty() const { return queue.empty(); }
+
+private:
+    struct Greater {
+        bool operator()(const MazeQueueEntry &lhs, const MazeQueueEntry &rhs) const { return rhs < lhs; }
+    };
+    std::priority_queue<MazeQueueEntry, vector<MazeQueueEntry>, Greater> queue;
+};
+
+// 2. D-ary heap, which is shallower and touches fewer cache lines than the binary one
+// Note: there is no decrease-key, as a vertex may hold several useful solutions (with different len)
+template <int D>
+class DaryMazeQueue {
+public:
+    void push(const MazeQueueEntry &entry) {
+        int i = heap.size();
+        heap.push_back(entry);
+        while (i > 0 && heap[i] < heap[(i - 1) / D]) {
+            std::swap(heap[i], heap[(i - 1) / D]);
+            i = (i - 1) / D;
+        }
+    }
+    MazeQueueEntry pop() {
+        MazeQueueEntry top = heap[0];
+        MazeQueueEntry last = heap.back();
+        heap.pop_back();
+        int size = heap.size();
+        if (size == 0) return top;
+        int i = 0;
+        while (true) {
+            int first = i * D + 1;
+            if (first >= size) break;
+            int minChild = first;
+            for (int c = first + 1; c < std::min(first + D, size); ++c) {
+                if (heap[c] < heap[minChild]) minChild = c;
+            }
+            if (!(heap[minChild] < last)) break;
+            heap[i] = heap[minChild];
+            i = minChild;
+        }
+        heap[i] = last;
+        return top;
+    }
+    bool empty() const { return heap.empty(); }
+
+private:
+    vector<MazeQueueEntry> heap;
+};
+
+// 3. Radix heap on the bit patterns of cost (which preserve the order of doubles, i.e., no quantization)
+// Entries in bucket i (i > 0) differ from the last popped cost at bit i - 1 at the highest, and bucket 0 holds the
+// ones equal to it as a heap by costUB.
+// A radix heap requires monotone keys, but the maze search restarts from zero-cost paths once a pin is reached, so a
+// push below the last popped cost rebases all the entries (once per pin).
+class RadixMazeQueue {
+public:
+    void push(const MazeQueueEntry &entry) {
+        uint64_t key = toKey(entry.cost);
+        if (key < last) rebase(key);
+        insert(entry, key);
+        ++numEntries;
+    }
+    MazeQueueEntry pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            last = toKey(std::min_element(buckets[i].begin(), buckets[i].end())->cost);
+            vector<MazeQueueEntry> entries;
+            entries.swap(buckets[i]);
+            for (const auto &entry : entries) insert(entry, toKey(entry.cost));
+            entries.clear();
+            buckets[i].swap(entries);  // keep the capacity
+        }
+        std::pop_heap(buckets[0].begin(), buckets[0].end(), greaterUB);
+        MazeQueueEntry entry = buckets[0].back();
+        buckets[0].pop_back();
+        --numEntries;
+        return entry;
+    }
+    bool empty() const { return numEntries == 0; }
+
+private:
+    std::array<vector<MazeQueueEntry>, 65> buckets;
+    uint64_t last = 0;
+    int numEntries = 0;
+
+    static uint64_t toKey(db::CostT cost) {
+        uint64_t bits;
+        std::memcpy(&bits, &cost, sizeof(bits));
+        return (bits >> 63) ? ~bits : (bits | (1ULL << 63));
+    }
+    static bool greaterUB(const MazeQueueEntry &lhs, const MazeQueueEntry &rhs) { return rhs.costUB < lhs.costUB; }
+    void insert(const MazeQueueEntry &entry, uint64_t key) {
+        if (key == last) {
+            buckets[0].push_back(entry);
+            std::push_heap(buckets[0].begin(), buckets[0].end(), greaterUB);
+        } else {
+            buckets[64 - __builtin_clzll(key ^ last)].push_back(entry);
+        }
+    }
+    void rebase(uint64_t newLast) {
+        vector<MazeQueueEntry> entries;
+        for (auto &bucket : buckets) {
+            entries.insert(entries.end(), bucket.begin(), bucket.end());
+            bucket.clear();
+        }
+        last = newLast;
+        for (const auto &entry : entries) insert(entry, toKey(entry.cost));
+    }
+};
@@ -1,22 +1,45 @@
 #include "MazeRoute.h"
 #include "UpdateDB.h"
 
+namespace {
+// Solutions are trivially destructible, so clearing the arena for a new net is O(1) and keeps its capacity
+vector<Solution> &solutionArena() {
+    thread_local vector<Solution> sols;
+    return sols;
+}
+
+struct QueueBenchStat {
+    std::atomic<int64_t> nanoseconds{0};
+    std::atomic<int> numNets{0};
+};
+std::array<QueueBenchStat, db::MazeQueueT::_size_constant> queueBenchStats;
+
+}  // namespace
+
 ostream &operator<<(ostream &os, const Solution &sol) {
-    os << "cost=" << sol.cost << ", len=" << sol.len << ", vertex=" << sol.vertex
-       << ", prev=" << (sol.prev ? sol.prev->vertex : -1);
+    os << "cost=" << sol.cost << ", len=" << sol.len << ", vertex=" << sol.vertex << ", prev=" << sol.prev;
     return os;
 }
 
+MazeRoute::MazeRoute(LocalNet &localNetData) : localNet(localNetData), sols(solutionArena()) {}
+
 db::RouteStatus MazeRoute::run() {
     GridGraphBuilder graphBuilder(localNet, graph);
     graphBuilder.run();
 
-    vertexCostUBs.assign(graph.getNodeNum(), std::numeric_limits<db::CostT>::max());
-    // vertexCostLBs.assign(graph.getNodeNum(), 0);
-    pinSols.assign(localNet.numOfPins(), nullptr);
     const int startPin = 0;
 
-    auto status = route(startPin);
+    if (db::setting.singleNetMazeQueueBench) {
+        for (auto queueType : db::MazeQueueT::_values()) {
+            utils::timer queueTimer;
+            route(startPin, queueType);
+            auto &stat = queueBenchStats[queueType._to_integral()];
+            stat.nanoseconds += int64_t(queueTimer.elapsed() * 1e9);
+            ++stat.numNets;
+        }
+    }
+
+    auto status = route(startPin, db::setting.singleNetMazeQueue);
     if (!db::isSucc(status)) {
         return status;
     }
@@ -27,116 +50,202 @@ db::RouteStatus MazeRoute::run() {
     return status;
 }
 
+void MazeRoute::printQueueBench() {
+    std::ostringstream oss;
+    oss << "Maze queue runtimes:";
+    for (auto queueType : db::MazeQueueT::_values()) {
+        auto &stat = queueBenchStats[queueType._to_integral()];
+        oss << " " << queueType._to_string() << "=" << stat.nanoseconds * 1e-9 << "s";
+        stat.nanoseconds = 0;
+    }
+    oss << " (" << queueBenchStats[0].numNets << " nets each)";
+    for (auto &stat : queueBenchStats) stat.numNets = 0;
+    log() << oss.str() << std::endl;
+}
+
+db::RouteStatus MazeRoute::route(int startPin, db::MazeQueueT queueType) {
+    vertexCostUBs.assign(graph.getNodeNum(), std::numeric_limits<db::CostT>::max());
+    // vertexCostLBs.assign(graph.getNodeNum(), 0);
+    sols.clear();
+    pinSols.assign(localNet.numOfPins(), -1);
+    // selected by pin count, but only when enabled (see Setting::singleNetMazeBidirectional)
+    if (db::setting.singleNetMazeBidirectional && localNet.numOfPins() == 2) {
+        if (queueType == +db::MazeQueueT::DARY) {
+            return routeBidirectional<DaryMazeQueue<4>>(startPin);
+        } else if (queueType == +db::MazeQueueT::RADIX) {
+            return routeBidirectional<RadixMazeQueue>(startPin);
+        } else {
+            return routeBidirectional<BinaryMazeQueue>(startPin);
+        }
+    }
+    if (queueType == +db::MazeQueueT::DARY) {
+        return route<DaryMazeQueue<4>>(startPin);
+    } else if (queueType == +db::MazeQueueT::RADIX) {
+        return route<RadixMazeQueue>(startPin);
+    } else {
+        return route<BinaryMazeQueue>(startPin);
+    }
+}
+
+void MazeRoute::initHeuristic(int startPin) {
+    pinBoxes.assign(localNet.numOfPins(), {});
+    pinLayerRanges.assign(localNet.numOfPins(), {});
+    unvisitedPins.clear();
+    for (int pinIdx = 0; pinIdx < localNet.numOfPins(); ++pinIdx) {
+        if (pinIdx == startPin || graph.getVertices(pinIdx).empty()) continue;
+        for (int vertex : graph.getVertices(pinIdx)) {
+            const db::GridPoint &point = graph.getGridPoint(vertex);
+            pinBoxes[pinIdx].Update(database.getLoc(point));
+            pinLayerRanges[pinIdx].Update(point.layerIdx);
+        }
+        unvisitedPins.push_back(pinIdx);
+    }
+    minViaCost = std::numeric_limits<db::CostT>::max();
+    for (int u = 0; u < graph.getNodeNum(); ++u) {
+        for (auto direction : directions) {
+            if (switchLayer(direction) && graph.hasEdge(u, direction)) {
+                minViaCost = min(minViaCost, graph.getEdgeCost(u, direction));
+            }
+        }
+    }
+}
+
+db::CostT MazeRoute::getHeuristic(int vertex) const {
+    if (unvisitedPins.empty()) return 0;
+    const db::GridPoint &point = graph.getGridPoint(vertex);
+    utils::PointT<DBU> loc = database.getLoc(point);
+    db::CostT heuristic = std::numeric_limits<db::CostT>::max();
+    for (int pinIdx : unvisitedPins) {
+        db::CostT dist = utils::Dist(pinBoxes[pinIdx], loc) / 2.0;
+        int numVias = utils::Dist(pinLayerRanges[pinIdx], point.layerIdx);
+        heuristic = min(heuristic, dist + numVias * minViaCost);
+    }
+    return heuristic;
+}
+
+// handle: (v, newCost, newLen, potentialPenalty)
+template <typename HandleT>
+void MazeRoute::expand(const Solution &sol, bool backward, const HandleT &handle) const {
+    int u = sol.vertex;
+    const db::MetalLayer &uLayer = database.getLayer(graph.getGridPoint(u).layerIdx);
+
+    int prevVertex = sol.prev != -1 ? sols[sol.prev].vertex : -1;
+
+    // the existing edges in the order of directions
+    for (unsigned dirs = graph.getEdgeDirs(u); dirs; dirs &= dirs - 1) {
+        auto direction = static_cast<EdgeDirection>(__builtin_ctz(dirs));
+        int v = graph.getEdgeEndPoint(u, direction);
+        if (v == prevVertex) continue;
+
+        // from u to v
+        const db::MetalLayer &vLayer = database.getLayer(graph.getGridPoint(v).layerIdx);
+        bool areOverlappedVertexes = (switchLayer(direction) && graph.getEdgeCost(u, direction) == 0);
+
+        // edge cost (a backward step pays the vertex cost of the one closer to the target, i.e., u)
+        db::CostT w =
+            areOverlappedVertexes ? 0 : graph.getEdgeCost(u, direction) + graph.getVertexCost(backward ? u : v);
+
+        // minArea penalty
+        db::CostT penalty = 0;
+        if (!areOverlappedVertexes && switchLayer(direction)) {
+            if (uLayer.hasMinLenVioAcc(sol.len)) {
+                if (graph.isMinAreaFixable(u) || graph.getPinIdx(u) != -1) {
+                    penalty = uLayer.getMinLen() - sol.len;
+                } else {
+                    penalty = database.getUnitMinAreaVioCost();
+                }
+            }
+        }
+
+        db::CostT newCost = w + sol.cost + penalty;
+        DBU newLen;
+        const db::GridPoint &vPoint = graph.getGridPoint(v);
+        if (graph.getGridPoint(u).layerIdx == graph.getGridPoint(v).layerIdx) {
+            const db::GridPoint &uPoint = graph.getGridPoint(u);
+            newLen = sol.len;
+            utils::IntervalT<int> cpRange =
+                uPoint.crossPointIdx < vPoint.crossPointIdx
+                    ? utils::IntervalT<int>(uPoint.crossPointIdx, vPoint.crossPointIdx)
+                    : utils::IntervalT<int>(vPoint.crossPointIdx, uPoint.crossPointIdx);
+            utils::IntervalT<int> trackRange = uPoint.trackIdx < vPoint.trackIdx
+                                                   ? utils::IntervalT<int>(uPoint.trackIdx, vPoint.trackIdx)
+                                                   : utils::IntervalT<int>(vPoint.trackIdx, uPoint.trackIdx);
+            newLen += uLayer.getCrossPointRangeDist(cpRange);
+            newLen += uLayer.pitch * trackRange.range();
+        } else {
+            newLen = 0;
+        }
+        newLen = min(newLen, database.getLayer(graph.getGridPoint(v).layerIdx).getMinLen());
+
+        // potential minArea penalty
+        db::CostT potentialPenalty = 0;
+        if (vLayer.hasMinLenVioAcc(newLen)) {
+            if (graph.isMinAreaFixable(v) || graph.getPinIdx(v) != -1) {
+                potentialPenalty = vLayer.getMinLen() - newLen;
+            } else {
+                potentialPenalty = database.getUnitMinAreaVioCost();
+            }
+        }
+        handle(v, newCost, newLen, potentialPenalty);
+    }
+}
+
+template <typename QueueT>
 db::RouteStatus MazeRoute::route(int startPin) {
-    // define std::priority_queue
-    auto solComp = [](const std::shared_ptr<Solution> &lhs, const std::shared_ptr<Solution> &rhs) {
-        return rhs->cost < lhs->cost || (rhs->cost == lhs->cost && rhs->costUB < lhs->costUB);
-    };
-    std::priority_queue<std::shared_ptr<Solution>, vector<std::shared_ptr<Solution>>, decltype(solComp)> solQueue(
-        solComp);
+    QueueT solQueue;
+    const bool aStar = db::setting.singleNetMazeAStar;
+    if (aStar) initHeuristic(startPin);
 
-    auto updateSol = [&](const std::shared_ptr<Solution> &sol) {
-        solQueue.push(sol);
-        if (sol->costUB < vertexCostUBs[sol->vertex]) {
-            vertexCostUBs[sol->vertex] = sol->costUB;
+    // with A*, the queue is keyed by cost + heuristic, which is consistent, i.e., a key never drops below the popped one
+    // Note: the keys pushed before reaching a pin are not updated after it, which is still safe, as the heuristic only
+    // increases with fewer unvisited pins (i.e., the old keys are still lower bounds)
+    auto updateSol = [&](db::CostT cost, DBU len, db::CostT costUB, int vertex, int prev) {
+        sols.emplace_back(cost, len, costUB, vertex, prev);
+        db::CostT heuristic = aStar ? getHeuristic(vertex) : 0;
+        solQueue.push({cost + heuristic, costUB + heuristic, int(sols.size()) - 1});
+        if (costUB < vertexCostUBs[vertex]) {
+            vertexCostUBs[vertex] = costUB;
         }
     };
 
     // init from startPin
     for (auto vertex : graph.getVertices(startPin)) {
         DBU minLen = graph.isFakePin(vertex) ? 0 : database.getLayer(graph.getGridPoint(vertex).layerIdx).getMinLen();
-        updateSol(std::make_shared<Solution>(
-            graph.getVertexCost(vertex), minLen, graph.getVertexCost(vertex), vertex, nullptr));
+        updateSol(graph.getVertexCost(vertex), minLen, graph.getVertexCost(vertex), vertex, -1);
     }
     std::unordered_set<int> visitedPin = {startPin};
     int nPinToConnect = localNet.numOfPins() - 1;
 
     while (nPinToConnect != 0) {
-        std::shared_ptr<Solution> dstVertex;
+        int dstVertex = -1;
         int dstPinIdx = -1;
 
-        // Dijkstra
+        // Dijkstra (or A*)
         while (!solQueue.empty()) {
-            auto newSol = solQueue.top();
-            int u = newSol->vertex;
-            solQueue.pop();
+            int newSolIdx = solQueue.pop().sol;
+            const Solution newSol = sols[newSolIdx];  // a copy, as updateSol may grow the arena
+            int u = newSol.vertex;
 
             // reach a pin?
             dstPinIdx = graph.getPinIdx(u);
             if (dstPinIdx != -1 && visitedPin.find(dstPinIdx) == visitedPin.end()) {
-                dstVertex = newSol;
+                dstVertex = newSolIdx;
                 break;
             }
 
             // pruning by upper bound
-            if (vertexCostUBs[u] < newSol->cost) continue;
-
-            const db::MetalLayer &uLayer = database.getLayer(graph.getGridPoint(u).layerIdx);
+            if (vertexCostUBs[u] < newSol.cost) continue;
 
-            for (auto direction : directions) {
-                if (!graph.hasEdge(u, direction) ||
-                    (newSol->prev && graph.getEdgeEndPoint(u, direction) == newSol->prev->vertex)) {
-                    continue;
-                }
-
-                // from u to v
-                int v = graph.getEdgeEndPoint(u, direction);
-                const db::MetalLayer &vLayer = database.getLayer(graph.getGridPoint(v).layerIdx);
-                bool areOverlappedVertexes = (switchLayer(direction) && graph.getEdgeCost(u, direction) == 0);
-
-                // edge cost
-                db::CostT w = areOverlappedVertexes ? 0 : graph.getEdgeCost(u, direction) + graph.getVertexCost(v);
-
-                // minArea penalty
-                db::CostT penalty = 0;
-                if (!areOverlappedVertexes && switchLayer(direction)) {
-                    if (uLayer.hasMinLenVioAcc(newSol->len)) {
-                        if (graph.isMinAreaFixable(u) || dstPinIdx != -1) {
-                            penalty = uLayer.getMinLen() - newSol->len;
-                        } else {
-                            penalty = database.getUnitMinAreaVioCost();
-                        }
-                    }
-                }
-
-                db::CostT newCost = w + newSol->cost + penalty;
-                DBU newLen;
-                const db::GridPoint &vPoint = graph.getGridPoint(v);
-                if (graph.getGridPoint(u).layerIdx == graph.getGridPoint(v).layerIdx) {
-                    const db::GridPoint &uPoint = graph.getGridPoint(u);
-                    newLen = newSol->len;
-                    utils::IntervalT<int> cpRange =
-                        uPoint.crossPointIdx < vPoint.crossPointIdx
-                            ? utils::IntervalT<int>(uPoint.crossPointIdx, vPoint.crossPointIdx)
-                            : utils::IntervalT<int>(vPoint.crossPointIdx, uPoint.crossPointIdx);
-                    utils::IntervalT<int> trackRange = uPoint.trackIdx < vPoint.trackIdx
-                                                           ? utils::IntervalT<int>(uPoint.trackIdx, vPoint.trackIdx)
-                                                           : utils::IntervalT<int>(vPoint.trackIdx, uPoint.trackIdx);
-                    newLen += uLayer.getCrossPointRangeDist(cpRange);
-                    newLen += uLayer.pitch * trackRange.range();
-                } else {
-                    newLen = 0;
-                }
-                newLen = min(newLen, database.getLayer(graph.getGridPoint(v).layerIdx).getMinLen());
-
-                // potential minArea penalty
-                db::CostT potentialPenalty = 0;
-                if (vLayer.hasMinLenVioAcc(newLen)) {
-                    if (graph.isMinAreaFixable(v) || graph.getPinIdx(v) != -1) {
-                        potentialPenalty = vLayer.getMinLen() - newLen;
-                    } else {
-                        potentialPenalty = database.getUnitMinAreaVioCost();
-                    }
-                }
+            expand(newSol, false, [&](int v, db::CostT newCost, DBU newLen, db::CostT potentialPenalty) {
                 // if (newCost < vertexCostUBs[v] && !(newCost == vertexCostLBs[v] && (newCost + potentialPenalty) ==
                 // vertexCostUBs[v])) {
                 if (newCost < vertexCostUBs[v]) {
-                    updateSol(std::make_shared<Solution>(newCost, newLen, newCost + potentialPenalty, v, newSol));
+                    updateSol(newCost, newLen, newCost + potentialPenalty, v, newSolIdx);
                 }
-            }
+            });
         }
 
-        if (!dstVertex) {
+        if (dstVertex == -1) {
             printWarnMsg(db::RouteStatus::FAIL_DISCONNECTED_GRID_GRAPH, localNet.dbNet);
             return db::RouteStatus::FAIL_DISCONNECTED_GRID_GRAPH;
         }
@@ -145,38 +254,144 @@ db::RouteStatus MazeRoute::route(int startPin) {
         pinSols[dstPinIdx] = dstVertex;
 
         // mark the path to be zero
-        auto tmp = dstVertex;
-        while (tmp && tmp->cost != 0) {
-            DBU minLen = database.getLayer(graph.getGridPoint(tmp->vertex).layerIdx).getMinLen();
-            updateSol(std::make_shared<Solution>(0, minLen, 0, tmp->vertex, tmp->prev));
-            tmp = tmp->prev;
+        for (int tmp = dstVertex; tmp != -1 && sols[tmp].cost != 0; tmp = sols[tmp].prev) {
+            const Solution &tmpSol = sols[tmp];
+            DBU minLen = database.getLayer(graph.getGridPoint(tmpSol.vertex).layerIdx).getMinLen();
+            updateSol(0, minLen, 0, tmpSol.vertex, tmpSol.prev);
         }
 
         // mark all the accessbox of the pin to be almost zero
         for (auto vertex : graph.getVertices(dstPinIdx)) {
-            if (vertex == dstVertex->vertex) continue;
+            if (vertex == sols[dstVertex].vertex) continue;
             DBU minLen =
                 graph.isFakePin(vertex) ? 0 : database.getLayer(graph.getGridPoint(vertex).layerIdx).getMinLen();
-            updateSol(std::make_shared<Solution>(
-                graph.getVertexCost(vertex), minLen, graph.getVertexCost(vertex), vertex, nullptr));
+            updateSol(graph.getVertexCost(vertex), minLen, graph.getVertexCost(vertex), vertex, -1);
         }
 
         visitedPin.insert(dstPinIdx);
+        if (aStar) unvisitedPins.erase(std::find(unvisitedPins.begin(), unvisitedPins.end(), dstPinIdx));
         nPinToConnect--;
     }
 
     return db::RouteStatus::SUCC_NORMAL;
 }
 
+template <typename QueueT>
+db::RouteStatus MazeRoute::routeBidirectional(int startPin) {
+    const int endPin = 1 - startPin;
+    // 0: forward from startPin, 1: backward from endPin, whose solutions exclude the vertex cost of their own vertices
+    std::array<QueueT, 2> solQueues;
+    std::array<vector<db::CostT>, 2> costUBs;
+    costUBs[0].swap(vertexCostUBs);
+    costUBs[1].assign(graph.getNodeNum(), std::numeric_limits<db::CostT>::max());
+    // popped solutions of each vertex, as linked lists (vertex -> the last one, solution -> the previous one)
+    std::array<vector<int>, 2> settledHeads;
+    settledHeads[0].assign(graph.getNodeNum(), -1);
+    settledHeads[1].assign(graph.getNodeNum(), -1);
+    vector<int> settledNexts;
+
+    // meeting of a forward solution and a backward one at the same vertex
+    // the wire through the vertex is not charged by either side, so it is charged here if it violates min area (unless
+    // it ends at the target pin, which a forward search does not charge either)
+    db::CostT bestCost = std::numeric_limits<db::CostT>::max();
+    std::array<int, 2> bestSols = {-1, -1};
+    auto getMeetingCost = [&](const Solution &fwdSol, const Solution &bwdSol) {
+        db::CostT cost = fwdSol.cost + bwdSol.cost;
+        if (bwdSol.prev == -1) return cost;
+        const db::MetalLayer &layer = database.getLayer(graph.getGridPoint(fwdSol.vertex).layerIdx);
+        DBU len = fwdSol.len + bwdSol.len;
+        if (layer.hasMinLenVioAcc(len)) {
+            if (graph.isMinAreaFixable(fwdSol.vertex) || graph.getPinIdx(fwdSol.vertex) != -1) {
+                cost += layer.getMinLen() - len;
+            } else {
+                cost += database.getUnitMinAreaVioCost();
+            }
+        }
+        return cost;
+    };
+    auto meet = [&](int dir, int solIdx) {
+        for (int other = settledHeads[1 - dir][sols[solIdx].vertex]; other != -1; other = settledNexts[other]) {
+            int fwdSolIdx = dir == 0 ? solIdx : other;
+            int bwdSolIdx = dir == 0 ? other : solIdx;
+            db::CostT cost = getMeetingCost(sols[fwdSolIdx], sols[bwdSolIdx]);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSols = {fwdSolIdx, bwdSolIdx};
+            }
+        }
+    };
+
+    // meetings are checked on both push (with the popped solutions of the other side) and pop
+    auto updateSol = [&](int dir, db::CostT cost, DBU len, db::CostT costUB, int vertex, int prev) {
+        sols.emplace_back(cost, len, costUB, vertex, prev);
+        solQueues[dir].push({cost, costUB, int(sols.size()) - 1});
+        if (costUB < costUBs[dir][vertex]) {
+            costUBs[dir][vertex] = costUB;
+        }
+        meet(dir, sols.size() - 1);
+    };
+    for (auto vertex : graph.getVertices(startPin)) {
+        DBU minLen = graph.isFakePin(vertex) ? 0 : database.getLayer(graph.getGridPoint(vertex).layerIdx).getMinLen();
+        updateSol(0, graph.getVertexCost(vertex), minLen, graph.getVertexCost(vertex), vertex, -1);
+    }
+    for (auto vertex : graph.getVertices(endPin)) {
+        DBU minLen = graph.isFakePin(vertex) ? 0 : database.getLayer(graph.getGridPoint(vertex).layerIdx).getMinLen();
+        updateSol(1, 0, minLen, 0, vertex, -1);
+    }
+
+    // each side pops in increasing cost, so it stops once the two last popped costs add up to the best meeting
+    std::array<db::CostT, 2> lastCosts = {0, 0};
+    while (!solQueues[0].empty() || !solQueues[1].empty()) {
+        int dir = solQueues[1].empty() || (!solQueues[0].empty() && lastCosts[0] <= lastCosts[1]) ? 0 : 1;
+        int newSolIdx = solQueues[dir].pop().sol;
+        const Solution newSol = sols[newSolIdx];  // a copy, as updateSol may grow the arena
+        lastCosts[dir] = newSol.cost;
+        if (lastCosts[0] + lastCosts[1] >= bestCost) break;
+        int u = newSol.vertex;
+
+        // pruning by upper bound
+        if (costUBs[dir][u] < newSol.cost) continue;
+
+        // meet the other side
+        settledNexts.resize(sols.size(), -1);
+        settledNexts[newSolIdx] = settledHeads[dir][u];
+        settledHeads[dir][u] = newSolIdx;
+        meet(dir, newSolIdx);
+
+        expand(newSol, dir == 1, [&](int v, db::CostT newCost, DBU newLen, db::CostT potentialPenalty) {
+            if (newCost < costUBs[dir][v]) {
+                updateSol(dir, newCost, newLen, newCost + potentialPenalty, v, newSolIdx);
+            }
+        });
+    }
+    costUBs[0].swap(vertexCostUBs);
+
+    if (bestSols[0] == -1) {
+        printWarnMsg(db::RouteStatus::FAIL_DISCONNECTED_GRID_GRAPH, localNet.dbNet);
+        return db::RouteStatus::FAIL_DISCONNECTED_GRID_GRAPH;
+    }
+
+    // append the backward path to the forward one (the costs of the appended solutions are not used)
+    int pathEnd = bestSols[0];
+    for (int bwdSolIdx = sols[bestSols[1]].prev; bwdSolIdx != -1; bwdSolIdx = sols[bwdSolIdx].prev) {
+        sols.emplace_back(bestCost, sols[bwdSolIdx].len, bestCost, sols[bwdSolIdx].vertex, pathEnd);
+        pathEnd = sols.size() - 1;
+    }
+    pinSols[endPin] = pathEnd;
+
+    return db::RouteStatus::SUCC_NORMAL;
+}
+
 void MazeRoute::getResult() {
     std::unordered_map<int, std::shared_ptr<db::GridSteiner>> visited;
 
     // back track from pin to source
     for (unsigned p = 0; p < localNet.numOfPins(); p++) {
         std::unordered_map<int, std::shared_ptr<db::GridSteiner>> curVisited;
-        auto cur = pinSols[p];
+        int curIdx = pinSols[p];
         std::shared_ptr<db::GridSteiner> prevS;
-        while (cur) {
+        while (curIdx != -1) {
+            const Solution *cur = &sols[curIdx];
             auto it = visited.find(cur->vertex);
             if (it != visited.end()) {
                 // graft to an existing node
@@ -196,13 +411,13 @@ void MazeRoute::getResult() {
                 }
                 curVisited.emplace(cur->vertex, curS);
                 // store tree root
-                if (!(cur->prev)) {
+                if (cur->prev == -1) {
                     localNet.gridTopo.push_back(curS);
                     break;
                 }
                 // prep for the next loop
                 prevS = curS;
-                cur = cur->prev;
+                curIdx = cur->prev;
             }
         }
         for (const auto &v : curVisited) visited.insert(v);
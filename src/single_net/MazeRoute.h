@@ -1,35 +1,62 @@
 #pragma once
 
 #include "GridGraphBuilder.h"
+#include "MazeQueue.h"
 
+// Search label, which lives in a per-thread arena (see MazeRoute.cpp) and refers to its predecessor by index
 class Solution {
 public:
     db::CostT cost;
     DBU len;           // length on current track
     db::CostT costUB;  // cost upper bound
     int vertex;
-    std::shared_ptr<Solution> prev;
+    int prev;  // index in the arena, -1 for none
 
-    Solution(db::CostT c, DBU l, db::CostT ub, int v, const std::shared_ptr<Solution> &p)
-        : cost(c), len(l), costUB(ub), vertex(v), prev(p) {}
+    Solution(db::CostT c, DBU l, db::CostT ub, int v, int p) : cost(c), len(l), costUB(ub), vertex(v), prev(p) {}
 
     friend ostream &operator<<(ostream &os, const Solution &sol);
 };
 
 class MazeRoute {
 public:
-    MazeRoute(LocalNet &localNetData) : localNet(localNetData) {}
+    MazeRoute(LocalNet &localNetData);
 
     db::RouteStatus run();
 
+    // runtimes of the maze queues since the last call (setting.singleNetMazeQueueBench), and reset them
+    static void printQueueBench();
+
 private:
     LocalNet &localNet;
     GridGraph graph;
 
     vector<db::CostT> vertexCostUBs;       // min cost upper bound for each vertex
     // vector<db::CostT> vertexCostLBs;       // cost lower bound corresponding to the min-upper-bound solution for each vertex
-    vector<std::shared_ptr<Solution>> pinSols;  // best solution for each pin
-
+    vector<Solution> &sols;                // all the solutions of the current net (the per-thread arena)
+    vector<int> pinSols;                   // best solution for each pin (index in sols)
+
+    // A* heuristic: min over the unvisited pins of
+    // Manhattan distance to the bounding box of the pin vertices / 2 +
+    // # layers to the layer range of the pin vertices * min via cost.
+    // A wire between cross points a < b is charged by the midpoints of the gaps around them (MetalLayer::
+    // accCrossPointDistCost), i.e., at least half of its length, a wrong-way edge costs wrongWayPenaltyCoeff (> 1/2)
+    // pitches, and a via keeps the location, so no edge costs less than the drop of the heuristic over it (i.e., it is
+    // consistent).
+    vector<utils::BoxT<DBU>> pinBoxes;
+    vector<utils::IntervalT<int>> pinLayerRanges;
+    vector<int> unvisitedPins;
+    db::CostT minViaCost;
+    void initHeuristic(int startPin);
+    db::CostT getHeuristic(int vertex) const;
+
+    db::RouteStatus route(int startPin, db::MazeQueueT queueType);
+    template <typename QueueT>
     db::RouteStatus route(int startPin);
+    // two-pin nets only (setting.singleNetMazeBidirectional)
+    template <typename QueueT>
+    db::RouteStatus routeBidirectional(int startPin);
+    // relax the edges from the vertex of sol, where a backward search goes from the target to the source
+    template <typename HandleT>
+    void expand(const Solution &sol, bool backward, const HandleT &handle) const;
     void getResult();
 };
@@ -3,27 +3,41 @@
 void UpdateDB::commitRouteResult(LocalNet &localNet, db::Net &dbNet) {
     // update db::Net
     dbNet.gridTopo = move(localNet.gridTopo);
-    // update RouteGrid
+    // update RouteGrid (vias in bulk)
+    vector<db::GridPoint> vias;
     dbNet.postOrderVisitGridTopo([&](std::shared_ptr<db::GridSteiner> node) {
         if (node->parent) {
-            database.useEdge({*node, *(node->parent)}, dbNet.idx);
+            db::GridEdge edge(*node, *(node->parent));
+            if (edge.isVia()) {
+                vias.push_back(edge.lowerGridPoint());
+            } else {
+                database.useEdge(edge, dbNet.idx);
+            }
         }
         if (node->extWireSeg) {
             database.useEdge(*(node->extWireSeg), dbNet.idx);
         }
     });
+    database.useVias(vias, dbNet.idx);
 }
 
 void UpdateDB::clearRouteResult(db::Net &dbNet) {
-    // update RouteGrid
+    // update RouteGrid (vias in bulk)
+    vector<db::GridPoint> vias;
     dbNet.postOrderVisitGridTopo([&](std::shared_ptr<db::GridSteiner> node) {
         if (node->parent) {
-            database.removeEdge({*node, *(node->parent)}, dbNet.idx);
+            db::GridEdge edge(*node, *(node->parent));
+            if (edge.isVia()) {
+                vias.push_back(edge.lowerGridPoint());
+            } else {
+                database.removeEdge(edge, dbNet.idx);
+            }
         }
         if (node->extWireSeg) {
             database.removeEdge(*(node->extWireSeg), dbNet.idx);
         }
     });
+    database.removeVias(vias, dbNet.idx);
     // update db::Net
     dbNet.clearResult();
 }
@@ -49,7 +63,7 @@ void UpdateDB::commitViaTypes(db::Net& dbNet) {
         if (!(node->parent)) return;
         db::GridEdge edge(*node, *(node->parent));
         if (!edge.isVia())  return;
-        database.markViaType(edge.lowerGridPoint(), node->viaType);
+        database.markViaType(edge.lowerGridPoint(), dbNet.idx, node->viaType);
     });
 };
 
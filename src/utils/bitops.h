@@ -0,0 +1,18 @@
+//
+// Kernels on bit masks stored in 64-bit words (bit i is bit (i % 64) of word (i / 64))
+// 1. "bitops::range_mask(low, high)" is the word with bits [low, high] set (0 <= low <= high <= 63)
+// It does not allocate memory.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace utils {
+
+class bitops {
+public:
+    static uint64_t range_mask(int low, int high) { return (~0ULL << low) & (~0ULL >> (63 - high)); }
+};
+
+}  // namespace utils
@@ -0,0 +1,125 @@
+#include "numa.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace utils {
+
+namespace {
+
+// parse a cpu/node list of sysfs, e.g., "0-3,8-11"
+std::vector<int> parseList(const std::string& str) {
+    std::vector<int> ids;
+    std::istringstream iss(str);
+    std::string range;
+    while (std::getline(iss, range, ',')) {
+        if (range.empty() || !std::isdigit(range[0])) continue;
+        auto dash = range.find('-');
+        int low = std::stoi(range.substr(0, dash));
+        int high = (dash == std::string::npos) ? low : std::stoi(range.substr(dash + 1));
+        for (int id = low; id <= high; ++id) ids.push_back(id);
+    }
+    return ids;
+}
+
+std::string readLine(const std::string& fileName) {
+    std::ifstream ifs(fileName);
+    std::string line;
+    std::getline(ifs, line);
+    return line;
+}
+
+std::vector<std::vector<int>> initNodes() {
+    std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+    // cpus allowed for this process (e.g., by taskset or cgroups)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return {{}};
+    }
+    std::vector<int> allCpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) allCpus.push_back(cpu);
+    }
+    const std::string nodeDir = "/sys/devices/system/node/";
+    for (int nodeIdx : parseList(readLine(nodeDir + "online"))) {
+        std::vector<int> cpus;
+        for (int cpu : parseList(readLine(nodeDir + "node" + std::to_string(nodeIdx) + "/cpulist"))) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) nodes.push_back(cpus);  // skip memory-only nodes
+    }
+    if (nodes.empty()) nodes.push_back(allCpus);
+#else
+    nodes.emplace_back();
+#endif
+    return nodes;
+}
+
+}  // namespace
+
+const std::vector<std::vector<int>>& numa::nodes() {
+    // read once, before any thread gets pinned
+    static const std::vector<std::vector<int>> nodes = initNodes();
+    return nodes;
+}
+
+int numa::node_of_thread(int threadIdx, int numThreads) {
+    return int64_t(threadIdx) * num_nodes() / std::max(1, numThreads);
+}
+
+bool numa::pin_thread(int threadIdx, int numThreads) {
+#if defined(__linux__)
+    int nodeIdx = node_of_thread(threadIdx, numThreads);
+    const auto& cpus = nodes()[nodeIdx];
+    if (cpus.empty()) return false;
+    int firstThreadIdx = 0;
+    while (node_of_thread(firstThreadIdx, numThreads) != nodeIdx) ++firstThreadIdx;
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpus[(threadIdx - firstThreadIdx) % cpus.size()], &cpuSet);
+    return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;  // 0 for the calling thread
+#else
+    return false;
+#endif
+}
+
+std::vector<double> numa::mem_use_per_node() {
+    std::vector<double> memUse;
+#if defined(__linux__)
+    // each line of numa_maps is a mapping with "N<node>=<pages> ... kernelpagesize_kB=<size>"
+    std::ifstream ifs("/proc/self/numa_maps");
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(line);
+        std::string token;
+        std::vector<std::pair<int, long>> pagesOnNodes;
+        long pageSize = 4;
+        while (iss >> token) {
+            auto eq = token.find('=');
+            if (eq == std::string::npos) continue;
+            if (token[0] == 'N' && std::isdigit(token[1])) {
+                pagesOnNodes.emplace_back(std::stoi(token.substr(1, eq - 1)), std::stol(token.substr(eq + 1)));
+            } else if (token.compare(0, eq, "kernelpagesize_kB") == 0) {
+                pageSize = std::stol(token.substr(eq + 1));
+            }
+        }
+        for (const auto& pages : pagesOnNodes) {
+            if (pages.first >= memUse.size()) memUse.resize(pages.first + 1, 0.0);
+            memUse[pages.first] += pages.second * pageSize / 1024.0;
+        }
+    }
+#endif
+    return memUse;
+}
+
+}  // namespace utils
@@ -0,0 +1,26 @@
+//
+// NUMA utilities based on Linux sysfs & syscalls only (no libnuma)
+// 1. "numa::nodes()" lists the cpus of each node that this process may run on (one node if unknown)
+// 2. "numa::pin_thread(threadIdx, numThreads)" binds the calling thread to one cpu, threads are spread over the nodes
+//    in contiguous blocks (i.e., threads [0, numThreads / numNodes) on the first node, and so on)
+// 3. "numa::mem_use_per_node()" is the resident memory (MB) of this process on each node
+// Memory is allocated on the node of the thread that first touches it (the default policy of Linux), so pinned
+// threads can place data on chosen nodes.
+//
+
+#pragma once
+
+#include <vector>
+
+namespace utils {
+
+class numa {
+public:
+    static const std::vector<std::vector<int>>& nodes();  // node -> cpus
+    static int num_nodes() { return nodes().size(); }
+    static int node_of_thread(int threadIdx, int numThreads);
+    static bool pin_thread(int threadIdx, int numThreads);
+    static std::vector<double> mem_use_per_node();  // MB
+};
+
+}  // namespace utils
@@ -0,0 +1,56 @@
+//
+// Spin locks for short critical sections
+// 1. "spin_lock" is a test-and-test-and-set lock padded to a cache line
+// 2. "striped_locks<N>" hashes keys to a fixed pool of N (a power of 2) spin locks, so that a huge number of objects
+//    (e.g., tracks) can be protected by a small amount of memory; different keys may share a lock, so never hold two
+//    of them at the same time
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace utils {
+
+class alignas(64) spin_lock {
+public:
+    void lock() {
+        while (_locked.exchange(true, std::memory_order_acquire)) {
+            while (_locked.load(std::memory_order_relaxed)) {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+            }
+        }
+    }
+    bool try_lock() {
+        return !_locked.load(std::memory_order_relaxed) && !_locked.exchange(true, std::memory_order_acquire);
+    }
+    void unlock() { _locked.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool> _locked{false};
+};
+
+template <size_t N>
+class striped_locks {
+    static_assert((N & (N - 1)) == 0, "N should be a power of 2");
+
+public:
+    spin_lock& get(uint64_t key) {
+        // 64-bit finalizer of MurmurHash3
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return _locks[key & (N - 1)];
+    }
+
+private:
+    std::array<spin_lock, N> _locks;
+};
+
+}  // namespace utils
@@ -0,0 +1,167 @@
+#include "threadpool.h"
+
+#include <algorithm>
+
+namespace utils {
+
+namespace {
+thread_local int curThreadIdx = -1;
+}
+
+int thread_pool::thread_idx() { return curThreadIdx; }
+
+void thread_pool::init(int numThreads) {
+    stop();
+    _numThreads = std::max(1, numThreads);
+    _queues = std::vector<job_queue>(_numThreads);
+    _durations.assign(_numThreads, 0.0);
+    _stopping = false;
+    _generation = 0;  // new workers start from generation 0, so a previous run() must not wake them
+    for (int i = 1; i < _numThreads; ++i) {
+        _workers.emplace_back(&thread_pool::worker_loop, this, i);
+    }
+}
+
+void thread_pool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _stopping = true;
+    }
+    _wakeCv.notify_all();
+    for (auto& worker : _workers) worker.join();
+    _workers.clear();
+}
+
+void thread_pool::run(int numJobs, int chunkSize, const std::function<void(int)>& handle, bool inOrder) {
+    if (_workers.empty() || curThreadIdx != -1 || numJobs <= 1) {
+        // sequential (nested runs keep the durations of the outer one)
+        timer seqTimer;
+        for (int i = 0; i < numJobs; ++i) handle(i);
+        if (curThreadIdx == -1) {
+            _durations.assign(_numThreads, 0.0);
+            _durations[0] = seqTimer.elapsed();
+        }
+        return;
+    }
+    dispatch(numJobs, std::max(1, chunkSize), handle, false, inOrder);
+}
+
+void thread_pool::run_on_all(const std::function<void(int)>& handle) {
+    if (_workers.empty() || curThreadIdx != -1) {
+        handle(std::max(0, curThreadIdx));
+        return;
+    }
+    dispatch(_numThreads, 1, handle, true, false);
+}
+
+void thread_pool::dispatch(int numJobs,
+                           int chunkSize,
+                           const std::function<void(int)>& handle,
+                           bool broadcast,
+                           bool inOrder) {
+    _handle = &handle;
+    _numJobs = numJobs;
+    _chunkSize = chunkSize;
+    _broadcast = broadcast;
+    _inOrder = inOrder;
+    _nextChunk = 0;
+
+    // deal contiguous chunk ranges, the rest is balanced by stealing
+    const int numChunks = (numJobs + chunkSize - 1) / chunkSize;
+    const int numActive = inOrder ? 0 : std::min(_numThreads, numChunks);
+    for (int i = 0; i < _numThreads; ++i) {
+        auto& queue = _queues[i];
+        std::lock_guard<std::mutex> lock(queue.mtx);
+        queue.begin = (i < numActive) ? (int64_t(i) * numChunks / numActive) : 0;
+        queue.end = (i < numActive) ? (int64_t(i + 1) * numChunks / numActive) : 0;
+    }
+    _durations.assign(_numThreads, 0.0);
+    _timer.start();
+
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _numBusy = _numThreads - 1;
+        ++_generation;
+    }
+    _wakeCv.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(_mtx);
+    _doneCv.wait(lock, [this] { return _numBusy == 0; });
+    _handle = nullptr;
+}
+
+void thread_pool::worker_loop(int threadIdx) {
+    unsigned seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mtx);
+            _wakeCv.wait(lock, [&] { return _stopping || _generation != seenGeneration; });
+            if (_stopping) return;
+            seenGeneration = _generation;
+        }
+        work(threadIdx);
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (--_numBusy == 0) _doneCv.notify_one();
+        }
+    }
+}
+
+void thread_pool::work(int threadIdx) {
+    curThreadIdx = threadIdx;
+    if (_broadcast) {
+        (*_handle)(threadIdx);
+        _durations[threadIdx] = _timer.elapsed();
+    } else if (_inOrder) {
+        const int numChunks = (_numJobs + _chunkSize - 1) / _chunkSize;
+        for (int chunkIdx = _nextChunk++; chunkIdx < numChunks; chunkIdx = _nextChunk++) {
+            const int begin = chunkIdx * _chunkSize;
+            const int end = std::min(begin + _chunkSize, _numJobs);
+            for (int i = begin; i < end; ++i) (*_handle)(i);
+            _durations[threadIdx] = _timer.elapsed();
+        }
+    } else {
+        int chunkIdx;
+        while (pop(threadIdx, chunkIdx) || (steal(threadIdx) && pop(threadIdx, chunkIdx))) {
+            const int begin = chunkIdx * _chunkSize;
+            const int end = std::min(begin + _chunkSize, _numJobs);
+            for (int i = begin; i < end; ++i) (*_handle)(i);
+            _durations[threadIdx] = _timer.elapsed();
+        }
+    }
+    curThreadIdx = -1;
+}
+
+bool thread_pool::pop(int threadIdx, int& chunkIdx) {
+    auto& queue = _queues[threadIdx];
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    if (queue.begin >= queue.end) return false;
+    chunkIdx = queue.begin++;
+    return true;
+}
+
+bool thread_pool::steal(int threadIdx) {
+    for (int i = 1; i < _numThreads; ++i) {
+        auto& victim = _queues[(threadIdx + i) % _numThreads];
+        int begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mtx);
+            int numLeft = victim.end - victim.begin;
+            if (numLeft <= 0) continue;
+            // take the back half, the owner keeps popping from the front
+            end = victim.end;
+            victim.end -= (numLeft + 1) / 2;
+            begin = victim.end;
+        }
+        auto& queue = _queues[threadIdx];
+        std::lock_guard<std::mutex> lock(queue.mtx);
+        queue.begin = begin;
+        queue.end = end;
+        return true;
+    }
+    return false;
+}
+
+}  // namespace utils
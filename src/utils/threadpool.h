@@ -0,0 +1,84 @@
+//
+// A persistent work-stealing thread pool
+// 1. "init(n)" creates n - 1 long-lived workers; the calling thread joins every run as worker 0
+// 2. "run(numJobs, chunkSize, handle)" splits [0, numJobs) into chunks, deals them to the workers, and lets idle
+//    workers steal half of the remaining chunks of a busy one
+//    (or, if inOrder, lets all workers take the chunks one by one in index order, i.e., list scheduling)
+// 3. "run_on_all(handle)" runs handle(threadIdx) exactly once on every worker
+// Runs issued from inside a job (or before init) fall back to the calling thread.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "log.h"
+
+namespace utils {
+
+class thread_pool {
+public:
+    thread_pool() = default;
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool() { stop(); }
+
+    void init(int numThreads);
+    void stop();
+    int size() const { return _numThreads; }
+
+    // handle(jobIdx); durations()[i] is the time (sec) worker i finished its last job
+    void run(int numJobs, int chunkSize, const std::function<void(int)>& handle, bool inOrder = false);
+    void run_on_all(const std::function<void(int)>& handle);
+    const std::vector<double>& durations() const { return _durations; }
+
+    // index of the current thread in the pool (-1 if it is not running a job of this pool)
+    static int thread_idx();
+
+private:
+    // chunk indices [begin, end) owned by one worker, padded to a cache line
+    struct job_queue {
+        std::mutex mtx;
+        int begin = 0;
+        int end = 0;
+        char pad[64 - (sizeof(std::mutex) + 2 * sizeof(int)) % 64];
+    };
+
+    int _numThreads = 1;
+    std::vector<std::thread> _workers;
+    std::vector<job_queue> _queues;
+    std::vector<double> _durations;
+    timer _timer;
+
+    // current job
+    const std::function<void(int)>* _handle = nullptr;
+    int _numJobs = 0;
+    int _chunkSize = 1;
+    bool _broadcast = false;
+    bool _inOrder = false;
+    std::atomic<int> _nextChunk{0};  // for inOrder
+
+    // wake up & done
+    std::mutex _mtx;
+    std::condition_variable _wakeCv;
+    std::condition_variable _doneCv;
+    unsigned _generation = 0;
+    int _numBusy = 0;
+    bool _stopping = false;
+
+    void worker_loop(int threadIdx);
+    void work(int threadIdx);
+    bool pop(int threadIdx, int& chunkIdx);
+    bool steal(int threadIdx);
+    void dispatch(int numJobs, int chunkSize, const std::function<void(int)>& handle, bool broadcast, bool inOrder);
+};
+
+}  // namespace utils
+
+// the global pool of the router (defined in db/Database.cpp)
+extern utils::thread_pool threadPool;
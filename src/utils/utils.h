@@ -3,4 +3,8 @@
 #include "geo.h"
 #include "log.h"
 #include "prettyprint.h"
-#include "enum.h"
\ No newline at end of file
+#include "enum.h"
+#include "bitops.h"
+#include "numa.h"
+#include "spinlock.h"
+#include "threadpool.h"
\ No newline at end of file